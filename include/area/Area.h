@@ -10,9 +10,6 @@ class Area: public QGraphicsPixmapItem{
 
 protected:
 
-    // If this area has a character or other objects
-    bool occupied_ = false;
-
     // Must be set before construct
     // setAreaSize() should be called
     static qreal AreaSize;
@@ -25,10 +22,6 @@ public:
 
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
 
-    bool isOccupied() const;
-
-    void setOccupied(bool occupied);
-
     // Used in qgraphicsitem_cast
     enum { Type = UserType + 1 };
     int type() const override;
@@ -0,0 +1,31 @@
+#ifndef AP_PROJ_ALLOCCOUNTER_H
+#define AP_PROJ_ALLOCCOUNTER_H
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * Counter of heap allocations made by the whole program, on all threads
+ * Allocation functions are replaced in AllocCounter.cpp (malloc() on glibc, operator new elsewhere),
+ * so it's linked into ap_bench only, and simulation library (AP_Sim) needs not know of it.
+ * Pass count() to TickProfiler::setCounter() to tell allocations made by each phase of tick.
+ */
+class AllocCounter{
+
+    static std::atomic<qint64> count_;
+
+public:
+
+    /**
+     * Returns number of allocations since program started
+     */
+    static qint64 count();
+
+    /**
+     * Called by replaced allocation functions only
+     */
+    static void add();
+
+};
+
+#endif //AP_PROJ_ALLOCCOUNTER_H
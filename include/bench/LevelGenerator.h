@@ -0,0 +1,51 @@
+#ifndef AP_PROJ_LEVELGENERATOR_H
+#define AP_PROJ_LEVELGENERATOR_H
+
+#include <QList>
+#include <QPoint>
+#include "Simulation.h"
+
+/**
+ * Utility class building synthetic levels in memory, e.g. for benchmarks
+ * Field is a zig-zag road: it runs along every other row, turning at both ends,
+ * from start area at top-left to Protection Objective at the end of last road row.
+ */
+class LevelGenerator{
+
+public:
+
+    using AreaIndex = QPoint;
+
+    struct Options{
+        int num_rows = 12;
+        int num_cols = 20;
+
+        int num_monsters = 10; // All of them are Boars, with mixed buffs
+        int spawn_duration = 10 * 1000; // Monsters arrive evenly in this time (ms)
+
+        // An Elf is placed on every `elf_spacing` grass areas beside road, 0 for none
+        int elf_spacing = 3;
+        // A Knight is placed on every `knight_spacing` road areas, 0 for none
+        int knight_spacing = 0;
+    };
+
+    /**
+     * Returns areas of the zig-zag road, in the order monsters go through
+     * Exception will be thrown if field is too small to have a road
+     */
+    static QList<AreaIndex> roadPath(int num_rows, int num_cols);
+
+    /**
+     * Returns a field of given size with the zig-zag road on it
+     */
+    static SimField zigZagField(int num_rows, int num_cols);
+
+    /**
+     * Load a synthetic level into `simulation`, and place characters on its field
+     * Health points are enough for all monsters, so that game does not end before they all arrive
+     */
+    static void generate(Simulation& simulation, const Options& options);
+
+};
+
+#endif //AP_PROJ_LEVELGENERATOR_H
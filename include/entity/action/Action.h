@@ -1,32 +1,32 @@
 #ifndef AP_PROJ_ACTION_H
 #define AP_PROJ_ACTION_H
 
-// #include "Entity.h"
-class Entity;
+// #include "SimEntity.h"
+struct SimEntity;
 
 /**
  * Base class of all action
- * An Action is between two Entities (initiator and acceptor).
+ * An Action is between two entities (initiator and acceptor) of the simulation.
  * May be attack, of other effect.
  */
 
 class Action{
 
-    Entity* initiator_;
-    Entity* acceptor_;
+    SimEntity* initiator_;
+    SimEntity* acceptor_;
 
 public:
 
-    explicit Action(Entity* initiator = nullptr, Entity* acceptor = nullptr);
+    explicit Action(SimEntity* initiator = nullptr, SimEntity* acceptor = nullptr);
 
     // Getters and setters
-    Entity* getInitiator() const;
+    SimEntity* getInitiator() const;
 
-    void setInitiator(Entity* initiator);
+    void setInitiator(SimEntity* initiator);
 
-    Entity* getAcceptor() const;
+    SimEntity* getAcceptor() const;
 
-    void setAcceptor(Entity* acceptor);
+    void setAcceptor(SimEntity* acceptor);
 
 };
 
@@ -2,6 +2,7 @@
 #define AP_PROJ_ACTIONATTACK_H
 
 #include <exception>
+#include <type_traits>
 #include "Action.h"
 #include "Buff.h"
 #include "ElementUtil.h"
@@ -10,6 +11,8 @@
 /**
  * When entity X attacks entity Y, we construct an ActionAttack with necessary info,
  * and convey it to entity attacked
+ * It's a small record of plain values (text effect is kept as a Reaction id rather than a string),
+ * so it's copied by memcpy and never allocates, however many AOE attacks are made in a tick.
  */
 class ActionAttack: public Action{
 
@@ -20,7 +23,7 @@ class ActionAttack: public Action{
     // When an entity is attacked, entities around get attacked too (range attack),
     // the former "transmits" damage to entities around,
     // and during the process this counter should decrease by one.
-    // If counter is 0, do nothing in Entity::attack()
+    // If counter is 0, do nothing in Simulation::attacked()
     int transmit_cnt_ = 1;
 
     // buff that the target will get, and duration (if buff is not NONE)
@@ -31,10 +34,9 @@ class ActionAttack: public Action{
     // may not be added to target, such as Anemo
     Element element_infusion_ = Element::NONE;
 
-    // Attributes of text effect: { text displayed, text color }
-    // Used in element reactions
-    QPair<QString, QColor> text_effect_;
-    bool has_effect_ = false;
+    // Element reaction made by this attack, whose text effect is displayed on target
+    // Text and color are looked up by ElementUtil::reactionToString() and ElementUtil::reactionToColor()
+    Reaction reaction_ = Reaction::NONE;
 
 
 public:
@@ -56,11 +58,11 @@ public:
 
     void setTransmitCnt(int cnt);
 
-    void setTextEffect(const QString& text, QColor color);
+    Reaction getReaction() const;
 
-    bool hasTextEffect() const;
-
-    const QPair<QString, QColor>& getTextEffect() const;
+    void setReaction(Reaction reaction);
 };
 
+static_assert(std::is_trivially_copyable_v<ActionAttack>, "ActionAttack should be a record of plain values");
+
 #endif //AP_PROJ_ACTIONATTACK_H
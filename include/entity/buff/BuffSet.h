@@ -0,0 +1,96 @@
+#ifndef AP_PROJ_BUFFSET_H
+#define AP_PROJ_BUFFSET_H
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include "BuffUtil.h"
+
+/**
+ * Buffs of an entity, along with time (ms) each one expires at
+ * Time is measured by a clock of the owner (refer to Simulation::status_time_),
+ * so nothing needs to be updated per tick until a buff expires.
+ * Stored as a bitmask of buffs (refer to BuffUtil::buffToMask()),
+ * and an array of expiry times indexed by ordinal of buff,
+ * so checking a buff is a single bit test, and nothing is allocated on heap.
+ */
+class BuffSet{
+
+    quint32 mask_ = 0;
+
+    // Expiry time (ms) of each buff, valid only if bit of the buff is set in mask_
+    qint64 expire_times_[BuffUtil::NUM_BUFFS] = {};
+
+public:
+
+    /**
+     * Returns bitmask of buffs in the set
+     */
+    inline quint32 mask() const{
+        return mask_;
+    }
+
+    inline bool contains(Buff buff) const{
+        return (mask_ & BuffUtil::buffToMask(buff)) != 0;
+    }
+
+    /**
+     * Returns if any buff in `mask` is in the set
+     */
+    inline bool intersects(quint32 mask) const{
+        return (mask_ & mask) != 0;
+    }
+
+    inline bool empty() const{
+        return mask_ == 0;
+    }
+
+    /**
+     * Returns number of buffs in the set
+     * If `mask` is given, only buffs in it are counted
+     */
+    int size(quint32 mask = ~0u) const;
+
+    /**
+     * Returns expiry time (ms) of buff, 0 if not in the set
+     */
+    qint64 expireTime(Buff buff) const;
+
+    /**
+     * Returns the earliest expiry time (ms) of buffs, std::numeric_limits<qint64>::max() if the set is empty
+     */
+    qint64 nextExpireTime() const;
+
+    /**
+     * Set expiry time of buff, and add it to the set if not in it
+     * Exception will be thrown if buff is Buff::NONE or invalid
+     */
+    void set(Buff buff, qint64 expire_time);
+
+    /**
+     * Remove buff from the set
+     * If buff is not in the set, just ignore it
+     */
+    void remove(Buff buff);
+
+    /**
+     * Remove buffs expiring at or before `time` (ms)
+     */
+    void expire(qint64 time);
+
+    /**
+     * Returns the buff with the smallest ordinal among buffs in `mask`, Buff::NONE if there is none
+     */
+    Buff first(quint32 mask = ~0u) const;
+
+    /**
+     * Call f(buff) for each buff in the set, in ascending order of ordinal
+     */
+    template<typename F>
+    void forEach(F&& f) const{
+        for(quint32 rest = mask_; rest; rest &= rest - 1)
+            f(BuffUtil::ordinalToBuff(qCountTrailingZeroBits(rest)));
+    }
+
+};
+
+#endif //AP_PROJ_BUFFSET_H
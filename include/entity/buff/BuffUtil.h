@@ -21,8 +21,53 @@ class BuffUtil{
     static constexpr const char* ICON_HYDRO = ":/icons/element_hydro.png";
     static constexpr const char* ICON_CRYO = ":/icons/element_cryo.png";
 
+    // Ordinal of Buff::INFUSION_PYRO, the first infusion buff
+    static constexpr const int ORDINAL_INFUSION_BEGIN = 6;
+
 public:
 
+    // Number of buffs (Buff::NONE not included), i.e. ordinals of buffs are in [0, NUM_BUFFS)
+    static constexpr const int NUM_BUFFS = 11;
+
+    /**
+     * Returns ordinal of buff, which is a small index in [0, NUM_BUFFS)
+     * Used to index arrays or bits of buffs, e.g. in BuffSet
+     * -1 for Buff::NONE or invalid buff
+     */
+    static constexpr int buffToOrdinal(Buff buff){
+        auto val = static_cast<int>(buff);
+        if(val >= static_cast<int>(Buff::WOLF_S_GRAVESTONE) && val <= static_cast<int>(Buff::EVER_CHANGING))
+            return val - static_cast<int>(Buff::WOLF_S_GRAVESTONE);
+        if(val >= static_cast<int>(Buff::INFUSION_PYRO) && val <= static_cast<int>(Buff::INFUSION_FROZEN))
+            return val - static_cast<int>(Buff::INFUSION_PYRO) + ORDINAL_INFUSION_BEGIN;
+        return -1;
+    }
+
+    /**
+     * Inverse of buffToOrdinal()
+     */
+    static constexpr Buff ordinalToBuff(int ordinal){
+        if(ordinal < 0 || ordinal >= NUM_BUFFS)
+            return Buff::NONE;
+        if(ordinal < ORDINAL_INFUSION_BEGIN)
+            return static_cast<Buff>(ordinal + static_cast<int>(Buff::WOLF_S_GRAVESTONE));
+        return static_cast<Buff>(ordinal - ORDINAL_INFUSION_BEGIN + static_cast<int>(Buff::INFUSION_PYRO));
+    }
+
+    /**
+     * Returns bit of buff in a mask of buffs, i.e. 1 << ordinal
+     * 0 for Buff::NONE or invalid buff
+     */
+    static constexpr quint32 buffToMask(Buff buff){
+        int ordinal = buffToOrdinal(buff);
+        return ordinal < 0 ? 0 : (1u << ordinal);
+    }
+
+    // Masks of categories of buffs, refer to isDeBuff() and isInfusionBuff()
+    // Note: they are defined below the class, for buffToMask() cannot be used before class is complete
+    static const quint32 DE_BUFF_MASK;
+    static const quint32 INFUSION_MASK;
+
     /**
      * Returns a const QList of buffs which characters can have.
      */
@@ -41,7 +86,7 @@ public:
     /**
      * Returns buff that given string indicated.
      * Exception will be thrown if invalid string is given.
-     * Used in monster data file loading
+     * Used in loading monster data file and placement file (of ap_eval)
      *
      * @param str buff's name in file, which is case-insensitive
      */
@@ -73,6 +118,12 @@ public:
       static bool isInfusionBuff(Buff buff);
 };
 
+inline constexpr const quint32 BuffUtil::DE_BUFF_MASK = buffToMask(Buff::CORRODED) | buffToMask(Buff::FROZEN);
+inline constexpr const quint32 BuffUtil::INFUSION_MASK = buffToMask(Buff::INFUSION_ANEMO)
+                                                       | buffToMask(Buff::INFUSION_CRYO)
+                                                       | buffToMask(Buff::INFUSION_HYDRO)
+                                                       | buffToMask(Buff::INFUSION_PYRO);
+
 
 inline quint64 qHash(const Buff& buff){
     return qHash(static_cast<int>(buff));
@@ -8,10 +8,11 @@
 
 
 /**
- * Abstract base class of all characters
+ * Abstract base class of graphics of all characters
  * When inherit this, you need to pay attention to these:
  * 1. SunCost needs to be defined, even if cost of your character is 0 too.
- * 2. You may need to override tryAttack() when needed
+ * 2. Attributes (damage, area condition, etc.) are set in SimEntity::create()
+ * 3. You may need to override showAttackEffect() when needed
  */
 class Character: public Entity{
 
@@ -23,31 +24,13 @@ protected:
 
 public:
 
-    static constexpr const int ON_GRASS = 0b01;
-    static constexpr const int ON_ROAD = 0b10;
-
-    /**
-     * static attribute of a character, needing to be redefined when in subclass
-     * if AreaCond & ON_GRASS:
-     * then: this character can be placed on grass
-     * if AreaCond & ON_ROAD:
-     * then: this character can be placed on road
-     * A character may be placed on grass and roads both
-     */
-    static constexpr const int AreaCond = 0b00;
-
     static constexpr const int SunCost = 0; // Cost to put this character
 
     using Entity::Entity;
 
-    /**
-     * Returns true if character can be placed on area with `cond`
-     */
-    virtual bool testAreaCond(int cond) = 0;
-
     static void setCharacterSize(qreal size);
 
-    void attack(ActionAttack& action, const QList<Entity*>& candidate_targets) override;
+    void showAttackEffect(Entity* target, Element element, EffectsLayer& effects) override;
 
     virtual QString getRandomVoice() const = 0;
 
@@ -19,8 +19,6 @@ public:
 
     static constexpr const char* TEXTURE = ":/images/elf.png";
 
-    static constexpr const int AreaCond = Character::ON_GRASS;
-
     static constexpr const int SunCost = 0; // Cost to put this character
 
     explicit Elf(QGraphicsItem *parent = nullptr);
@@ -29,9 +27,7 @@ public:
     enum { Type = UserType + 201 };
     int type() const override;
 
-    bool testAreaCond(int cond) override;
-
-    void attack(ActionAttack& action, const QList<Entity*>& candidate_targets) override;
+    void showAttackEffect(Entity* target, Element element, EffectsLayer& effects) override;
 
     QString getRandomVoice() const override;
 };
@@ -18,8 +18,6 @@ public:
 
     static constexpr const char* TEXTURE = ":/images/knight.png";
 
-    static constexpr const int AreaCond = Character::ON_GRASS | Character::ON_ROAD;
-
     static constexpr const int SunCost = 0; // Cost to put this character
 
     explicit Knight(QGraphicsItem *parent = nullptr);
@@ -28,9 +26,7 @@ public:
     enum { Type = UserType + 202 };
     int type() const override;
 
-    bool testAreaCond(int cond) override;
-
-    void attack(ActionAttack& action, const QList<Entity*>& candidate_targets) override;
+    void showAttackEffect(Entity* target, Element element, EffectsLayer& effects) override;
 
     QString getRandomVoice() const override;
 };
@@ -12,4 +12,17 @@ enum class Element{
 
 };
 
+/**
+ * Element reaction made by an attack, refer to ElementUtil::makeElementReaction()
+ * It's carried by ActionAttack and SimEvent as an id,
+ * and text and color of it are looked up by ElementUtil only when it's displayed.
+ */
+enum class Reaction{
+    NONE = 0,
+    VAPORIZE,
+    MELT,
+    FROZEN,
+    SWIRL,
+};
+
 #endif //AP_PROJ_ELEMENT_H
@@ -30,6 +30,18 @@ public:
      */
     static QString elementToIcon(Element element);
 
+    /**
+     * Returns text displayed when reaction happens, e.g. "Vaporize"
+     * Exception will be thrown for Reaction::NONE
+     */
+    static QString reactionToString(Reaction reaction);
+
+    /**
+     * Returns color of text displayed when reaction happens
+     * Exception will be thrown for Reaction::NONE
+     */
+    static QColor reactionToColor(Reaction reaction);
+
     /**
      * Returns element that infusion buff will attach to attack
      * e.g. If a character has buff "INFUSION_HYDRO", this method returns element "HYDRO"
@@ -41,7 +53,7 @@ public:
      * `action` would be changed to carry impacts of a reaction.<BR>
      * e.g.
      * Vaporize will multiply damage by 2 or 1.5,
-     * and info of reaction text effect would be added.
+     * and the reaction would be recorded in it, so that its text effect can be displayed.
      * <BR>
      * Element reactions available are listed below (made by https://ozh.github.io/ascii-tables/)
      * +----------------+-------------------------------+---------------------+---------------------------+--------+
@@ -65,6 +77,12 @@ public:
      */
     static bool canApplyAura(Element element);
 
+    /**
+     * Returns transmit counter of an attack carrying given element, see ActionAttack
+     * Anemo attacks hit entities around target, others only hit target
+     */
+    static int elementToTransmitCnt(Element element);
+
 };
 
 #endif //AP_PROJ_ELEMENTUTIL_H
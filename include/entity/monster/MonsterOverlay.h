@@ -0,0 +1,60 @@
+#ifndef AP_PROJ_MONSTEROVERLAY_H
+#define AP_PROJ_MONSTEROVERLAY_H
+
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QPixmap>
+#include <QColor>
+#include "SimEntity.h"
+
+/**
+ * Status of a monster drawn above its texture, i.e. health bar, buff icons and element aura icon
+ * All of them are painted by this single item from cached pixmaps,
+ * and it's repainted only when displayed status changes.
+ */
+class MonsterOverlay: public QGraphicsItem{
+
+    static constexpr const qreal BUFF_ICON_SIZE = 16; // px
+    static constexpr const qreal BUFF_ICON_SPACING = 2; // px
+    static constexpr const qreal AURA_ICON_SIZE = 32; // px
+    static constexpr const qreal HEALTH_BAR_HEIGHT = 4; // px
+
+    qreal monster_size_;
+
+    QRectF bounding_rect_;
+
+    // Status displayed now
+    int health_ = 0;
+    int max_health_ = 0;
+    quint32 buff_mask_ = 0; // Only buffs in BuffUtil::monsterBuffs() are displayed
+    Element element_aura_ = Element::NONE;
+
+    QPixmap aura_icon_;
+
+    /**
+     * Returns icons of buffs in BuffUtil::monsterBuffs(), in the same order
+     */
+    static const QList<QPixmap>& buffIcons();
+
+    static QColor getHealthBarColor(int health, int max_health);
+
+public:
+
+    explicit MonsterOverlay(qreal monster_size, QGraphicsItem *parent = nullptr);
+
+    enum { Type = UserType + 301 };
+    int type() const override;
+
+    QRectF boundingRect() const override;
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    /**
+     * Display status of monster
+     * Only parts marked in state.dirty are refreshed, and nothing is repainted if none is marked
+     */
+    void setState(const SimEntity& state);
+
+};
+
+#endif //AP_PROJ_MONSTEROVERLAY_H
@@ -5,11 +5,12 @@
 #include <QGraphicsPixmapItem>
 #include <QStringList>
 #include <QHash>
+#include <QMap>
 #include <QPair>
 #include <QPoint>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QtGlobal>
-#include <QRandomGenerator>
 #include <QPainter>
 #include <QPushButton>
 #include <QGraphicsLinearLayout>
@@ -20,6 +21,7 @@
 #include <QQueue>
 #include <functional>
 #include "BuffUtil.h"
+#include "ElementUtil.h"
 #include "Grass.h"
 #include "Road.h"
 #include "Entity.h"
@@ -28,11 +30,19 @@
 #include "Character.h"
 #include "Elf.h"
 #include "Knight.h"
+#include "Simulation.h"
+#include "TickProfiler.h"
+#include "Replay.h"
+#include "EffectsLayer.h"
 
 
+/**
+ * View of a level
+ * Game rules are run by simulation_, and GameField mirrors its state into graphics items after each tick.
+ * It also handles input of player (e.g. placing characters) and passes it to simulation_.
+ */
 class GameField: public QGraphicsScene{
 
-    using Direction = QPair<int, int>;
     using AreaIndex = QPoint;
 
     // Style of button
@@ -47,7 +57,6 @@ class GameField: public QGraphicsScene{
 
     static constexpr const char* BGM = "qrc:/sounds/GallantChallenge.m4a";
 
-    static constexpr const qreal AREA_SIZE = 48; // px
     static constexpr const qreal CHARACTER_OPTION_SIZE = 32; // px
     static constexpr const qreal BUFF_OPTION_SIZE = 32; // px
     static constexpr const qreal CHARACTER_SIZE = 48; // px
@@ -55,27 +64,53 @@ class GameField: public QGraphicsScene{
     static constexpr const qreal ICON_HEALTH_SIZE = 28; // px (origin image is 7*7, so...)
     static constexpr const qreal ICON_MONSTER_SIZE = 32; // px
 
-    static constexpr const qreal REAL_COMPENSATION = 0.0000001;
+    // If frames are late, at most this number of ticks are run to catch up in one frame,
+    // and the rest is dropped, so that a slow frame doesn't lead to even slower ones
+    static constexpr const int MAX_TICKS_PER_FRAME = 15;
+    // At MAX_SPEED, ticks run for at most this share of a frame interval,
+    // and the rest is left for syncing views and painting, so frames are still drawn and input handled
+    static constexpr const qreal MAX_SPEED_TICK_SHARE = 0.5;
+
+    // At most this number of visual effects (particles) are displayed at the same time
+    static constexpr const int MAX_PARTICLES = 256;
 
-    int num_rows_ = 0;
-    int num_cols_ = 0;
+public:
+
+    static constexpr const qreal AREA_SIZE = 48; // px
+    // Simulation runs at a fixed rate, no matter how fast frames are displayed
+    static constexpr const int TICK_INTERVAL = 16; // ms of game time per tick
+
+    // Speed of game, i.e. game time passed per wall-clock time
+    // MAX_SPEED means running as many ticks as fit in a share of a frame, refer to MAX_SPEED_TICK_SHARE
+    static constexpr const int NORMAL_SPEED = 1;
+    static constexpr const int MAX_SPEED = 0;
+
+private:
 
     QTimer timer_;
-    qint64 game_time_ = 0; // time (ms) since game start; It should be updated by updateField
-    qreal fps_ = 59; // refresh rate
+    qreal fps_ = 59; // refresh rate of display
+
+    // Wall-clock time since last frame, and the part of it not consumed by ticks yet
+    QElapsedTimer frame_clock_;
+    qint64 tick_accumulator_ = 0; // ns
 
-    // Queue of (monster, arrival time) pairs
-    // time (second of pair) should be sorted by ascending order
-    QQueue<QPair<Monster*, int>> monster_que_;
+    int speed_ = NORMAL_SPEED; // refer to setSpeed()
+
+    // Game rules and state of the level
+    Simulation simulation_;
 
     QList<QList<Area*>> areas_;
-    QList<Monster*> monsters_;
-    QList<Character*> characters_;
 
-    QList<AreaIndex> start_areas_idx_;
-    QList<AreaIndex> protect_areas_idx_;
+    // Graphics of entities in simulation_, with id of SimEntity as key
+    QHash<int, Entity*> entity_views_;
+
+    // Hidden graphics of monsters removed from field, by kind, reused by monsters generated later
+    // Owned by the scene
+    QMap<EntityKind, QList<Entity*>> monster_view_pool_;
 
-    int health_points_ = 1;
+    // All visual effects (attacks, text above entities) are displayed by this single item
+    // Owned by the scene
+    EffectsLayer* effects_ = new EffectsLayer(MAX_PARTICLES);
 
     // Below are components related to character.
     // place_options_ and upgrade_options_ each holds a layout, which may holds more than one options.
@@ -83,10 +118,6 @@ class GameField: public QGraphicsScene{
     // upgrade_options_ is used to upgrade or remove characters.
     QGraphicsWidget* place_options_ = new QGraphicsWidget;
     QGraphicsWidget* upgrade_options_ = new QGraphicsWidget;
-    // character_makers_ contains makers of characters that can be placed in this field.
-    // character_textures_ is list of file name of corresponding textures.
-    QList<std::function<Character*()>> character_makers_;
-    QStringList character_textures_;
 
     // buff_options_ holds a layout, which contains multiple buffs that can be used.
     // This layout should be visible when an area with character on it is selected
@@ -98,36 +129,30 @@ class GameField: public QGraphicsScene{
     QGraphicsSimpleTextItem* health_point_counter_;
     QGraphicsSimpleTextItem* monster_counter_;
 
+    // Time of each phase of a frame is recorded if set, not owned
+    TickProfiler* profiler_ = nullptr;
+    qint64 paint_start_ = 0; // ns, refer to drawBackground()
+
 
 public:
     explicit GameField(QObject* parent = nullptr);
 
     /**
-     * Load data from files
-     * dir_path should contain 3 files:
-     * field.dat: data of field
-     * characters.dat: characters can be used
-     * monsters.dat: monsters that will appear in this level, along with time of arrival
-     * level_setting.dat: other settings of this level, such as life points of player
+     * Load level from files, and set up UI of it
+     * Refer to Simulation::loadLevelFromFile() for files in dir_path, which may be a level pack (*.aplv) as well
      * @param dir_path const QString& directory having data of field, monsters and characters cna be used
      */
     void loadLevelFromFile(const QString& dir_path);
 
-    // Called by loadLevelFromFile()
-    void loadFieldFromFile(const QString& file_path);
-
-    // Called by loadLevelFromFile()
-    void loadCharacterOptionFromFile(const QString& file_path);
-
-    // Called by loadLevelFromFile()
-    void loadMonsterQueueFromFile(const QString& file_path);
-
-    // Called by loadLevelFromFile()
-    void loadLevelSettingFromFile(const QString& file_path);
-
     // Called by loadLevelFromFile()
     void loadStyleFromFile();
 
+    /**
+     * Initialize areas_ according to field of simulation_
+     * Must be called explicitly
+     */
+    void initFieldUi();
+
     /**
      * Initialize place_options_ and upgrade_options_
      * Must be called explicitly, for no other functions will call it
@@ -154,6 +179,35 @@ public:
 
     void setFps(qreal fps);
 
+    /**
+     * Set speed of game
+     * NORMAL_SPEED or any other positive value is a multiplier of game time per wall-clock time, e.g. 2 to make game run twice as fast
+     * MAX_SPEED to run ticks as many as possible, in half of each frame (MAX_SPEED_TICK_SHARE)
+     * When speed is not NORMAL_SPEED, graphics are only synced once a frame,
+     * and visual effects (e.g. particles) of ticks other than the last one are skipped.
+     */
+    void setSpeed(int speed);
+
+    int getSpeed() const;
+
+    /**
+     * Returns seed and commands of player of the game until now
+     * Level path is not known here, and left empty
+     */
+    Replay replay() const;
+
+    /**
+     * Replay a recorded game on the level loaded, player input is ignored from now on
+     * Should be called after loading level and before startGame()
+     */
+    void startReplay(const Replay& replay);
+
+    /**
+     * Record time of each phase of a frame in `profiler` (not owned), including ticks and painting scene
+     * nullptr to stop
+     */
+    void setProfiler(TickProfiler* profiler);
+
     /**
      * Start the game.
      * Should be called explicitly.
@@ -170,51 +224,62 @@ private:
 
     /**
      * Called by updateField()
-     * Move monsters in each frame
+     * Create graphics for entities new in simulation_, and mirror state of all entities into graphics
+     *
+     * @param alpha progress (0~1) of time from last tick to next one, used to interpolate movement
      */
-    void moveMonsters();
+    void syncEntityViews(qreal alpha);
 
     /**
      * Called by updateField()
-     * Check if monsters are to be generated in each frame.
-     * If so, do it.
+     * Handle events happened in simulation_ since last frame,
+     * e.g. display attack effects, remove graphics of dead entities
+     * When fast forwarding, visual effects of ticks other than the last one are skipped
      */
-    void generateMonsters();
+    void handleSimEvents();
 
     /**
      * Called by updateField()
-     * Update status of entities, e.g. buff, continuous damage...
+     * Update info in status bar, including health points and monster counter
+     * Only counters marked dirty in simulation_ are reset
      */
-    void updateEntityStatus();
+    void updateStatusBar();
 
     /**
-     * Called by updateField()
-     * Check monsters and characters, handle interactions between them
-     * e.g. An Elf tryAttack a Boar, a Boar attacks a Knight
+     * Returns new graphics of entity of given kind
      */
-    void entityInteract();
+    static Entity* createEntityView(EntityKind kind);
 
     /**
-     * Called by updateField()
-     * Update info in status bar, including health points and monster counter
+     * Returns graphics for a monster just generated, either from monster_view_pool_ or a new one added to the scene
      */
-    void updateStatusBar();
+    Entity* takeMonsterView(const SimEntity& state);
+
+    /**
+     * Create graphics of a character placed in simulation_, and put it in its area
+     */
+    Entity* createCharacterView(const SimEntity& state);
 
     /**
-     * Remove dead entities, including characters and monsters
+     * Returns file name of texture of character of given kind
      */
-    void removeDeadEntity();
+    static QString characterTexture(EntityKind kind);
 
     /**
-     * Remove specific character
-     * Note:
-     * Statement of area holding the character should be reset
-     * characters_ should be updated
+     * Returns index of area in this->areas_
      */
-    void removeCharacter(Character* character);
+    AreaIndex areaIndex(const Area* area) const;
 
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *mouseEvent) override;
 
+    /**
+     * Scene is painted between drawBackground() and drawForeground(),
+     * they're overridden to record time of painting in profiler_
+     */
+    void drawBackground(QPainter *painter, const QRectF &rect) override;
+
+    void drawForeground(QPainter *painter, const QRectF &rect) override;
+
     /**
      * Called when click on an area, either holding a character or not
      *
@@ -239,56 +304,32 @@ private:
     void getNewBuff();
 
     /**
-     * Returns character that in specific area
-     *
-     * @param area: area that you want to find character from
-     */
-    Character* getCharacterInArea(Area* area);
-
-    /**
-    * Returns {row_idx, col_idx} of the area which pos is at.
-    * If pos is out of rect of scene, a valid pair will still be returned.
-    * -1 <= row_idx <= num_rows, -1 <= col_idx <= num_cols.
-    */
-    static AreaIndex posToIndex(QPointF pos);
-
-    /**
-     * Return if r1 equals to r2
-     * Taking double precision into account
-     */
-    static inline bool qRealEqual(qreal r1, qreal r2) {
-        return qAbs(r1 - r2) <= REAL_COMPENSATION;
-    }
-
-    /**
-     * Return if pos1 equals to pos2
-     * Taking double precision into account
-     * Note: qRealEqual(qreal, qreal) is called in this method
+     * Delete graphics of entity with given id, if existing
+     * Graphics of a monster is hidden and put into monster_view_pool_ instead
+     * Text effects following it are fixed in place first
      */
-    static inline bool pointFloatEqual(const QPointF& p1, const QPointF& p2){
-        return qRealEqual(p1.x(), p2.x()) && qRealEqual(p1.y(), p2.y());
-    }
+    void removeEntityView(int entity_id);
 
     /**
-     * Check if any monster has reached the Protection Objective.
-     * If so, remove it from the field and minus health_points_ by 1.
-     * If
+     * Returns character that in specific area
+     *
+     * @param area: area that you want to find character from
      */
-    void checkReachProtectionObjective();
+    SimEntity* getCharacterInArea(const Area* area) const;
 
     /**
-     * Check if game is end
-     * Win: There no monster in field and monster_que_, and life_point_ > 0
-     * Lose: Otherwise
+     * Called by updateField()
+     * Check if game is end, and display the result if so
+     * Refer to Simulation::checkGameEnd() for conditions of win and lose
      */
     void checkGameEnd();
 
 private slots:
 
     /**
-     * Slot for game timer
+     * Slot for game timer, which is called once a frame
      * It should do all things controlled by game timer,
-     * e.g. move monsters, make tryAttack actions
+     * i.e. run ticks of simulation_ for time passed since last frame, then update graphics accordingly
      * In order to ensure they're called in fixed order, we have this slot
      * For more, please refer to implementation
      */
@@ -296,10 +337,10 @@ private slots:
 
     /**
      * Slot for placeCharacter button
-     * Note: need a lambda to pass parameter `type`
-     * @param type: type of character (call typeToCharacter() to make a new character)
+     * Note: need a lambda to pass parameter `kind`
+     * @param kind: kind of character
      */
-    void placeCharacter(const std::function<Character*()>& maker);
+    void placeCharacter(EntityKind kind);
 
     /**
      * Slot for upgradeCharacterFromUi button
@@ -5,6 +5,7 @@
 #include <QGraphicsView>
 #include <QVBoxLayout>
 #include "GameField.h"
+#include "TickProfiler.h"
 
 
 class MainWindow: public QMainWindow{
@@ -17,28 +18,72 @@ class MainWindow: public QMainWindow{
     // Directory path of level information
     QString level_data_path_;
 
+    // Settings of game field, which should be kept when game field is reset
+    int fps_ = 59;
+    int speed_ = GameField::NORMAL_SPEED;
+
+    // Records time of each phase of frames, when enabled from menu "Game > Profiler"
+    TickProfiler profiler_;
+
+    /**
+     * Replace game field with a new one on level in `level_path`, with settings kept, and remember the path
+     * Game is not started
+     * If level cannot be loaded, exception is thrown and game field is kept.
+     */
+    void newGameField(const QString& level_path);
+
 public:
 
     explicit MainWindow(QWidget *parent = nullptr);
 
     void startGame();
 
+    /**
+     * Ask player for a level directory, and replace game field with a new one on it
+     * Game is not started. Returns false if cancelled or level cannot be loaded, when game field is kept.
+     */
     bool openLevelDir();
 
 private slots:
 
     void resetGame();
 
+    /**
+     * Save the game until now as a replay file, refer to Replay
+     */
+    void saveReplay();
+
+    /**
+     * Open a replay file, and replay it on its level from the beginning
+     */
+    void openReplay();
+
     void pauseOrResumeGame(bool is_pause);
 
     /**
      * Load a new level from a directory during playing.
-     * Should call openLevelDir() and resetGame()
+     * Should call openLevelDir() and startGame()
      */
     void loadLevelDuringGame();
 
+    /**
+     * Load a new level from a compiled level file (*.aplv) during playing, refer to LevelPack
+     */
+    void loadLevelPackDuringGame();
+
     void setFps(int fps);
 
+    /**
+     * Set speed of game, refer to GameField::setSpeed()
+     */
+    void setSpeed(int speed);
+
+    /**
+     * Save samples recorded by profiler_ as Chrome trace JSON,
+     * which can be opened in chrome://tracing or Perfetto
+     */
+    void saveProfile();
+
 };
 
 
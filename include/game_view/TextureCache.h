@@ -0,0 +1,53 @@
+#ifndef AP_PROJ_TEXTURECACHE_H
+#define AP_PROJ_TEXTURECACHE_H
+
+#include <QPixmap>
+#include <QString>
+#include <QSize>
+#include <QHash>
+
+/**
+ * Process-wide cache of textures (pixmaps)
+ * Each image is decoded and scaled (and flipped if needed) only once for a (path, size, flip) key,
+ * later calls get an implicitly shared copy of it, so no pixel data is copied.
+ * Note: Should be used in GUI thread only, as QPixmap is.
+ */
+class TextureCache{
+
+    struct Key{
+        QString path;
+        QSize size;
+        bool horizontally_flipped;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    friend size_t qHash(const Key& key, size_t seed);
+
+    static QHash<Key, QPixmap>& cache();
+
+public:
+
+    /**
+     * Returns texture loaded from `path`, scaled to `size`
+     * If `horizontally_flipped`, it's mirrored, i.e. toward left if the image is toward right
+     * A null pixmap (scaled to nothing) would be returned if the image cannot be loaded
+     */
+    static QPixmap get(const QString& path, const QSize& size, bool horizontally_flipped = false);
+
+    /**
+     * Same as above, for square texture
+     */
+    static QPixmap get(const QString& path, int size, bool horizontally_flipped = false);
+
+    /**
+     * Remove all textures in cache
+     * Pixmaps handed out before are still valid
+     */
+    static void clear();
+
+    static int size();
+
+};
+
+#endif //AP_PROJ_TEXTURECACHE_H
@@ -0,0 +1,135 @@
+#ifndef AP_PROJ_EFFECTSLAYER_H
+#define AP_PROJ_EFFECTSLAYER_H
+
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QFont>
+#include <QList>
+#include <QLineF>
+#include <QColor>
+#include "ShootParticle.h"
+#include "MeleePrickParticle.h"
+#include "SimpleTextParticle.h"
+
+/**
+ * A single item displaying all visual effects (particles) of a scene
+ * Particles (e.g. ShootParticle) only describe an effect; set one up and pass it to add(),
+ * and EffectsLayer animates and paints it.
+ * Effects are kept as records in struct-of-arrays form, advanced by advanceTime() once a frame,
+ * and painted in one paint() call, instead of one graphics item with its own animations per effect.
+ * Number of effects displayed at the same time is limited, extra effects are just dropped.
+ * Note:
+ * * If a text effect is anchored to an item (e.g. text above a monster),
+ *   releaseAnchor() must be called before the item is deleted.
+ */
+class EffectsLayer: public QGraphicsItem{
+
+    // Records of shoots
+    struct Shoots{
+        QList<QPointF> start_pos;
+        QList<QPointF> end_pos;
+        QList<QColor> color;
+        QList<qreal> move_duration; // ms
+        QList<bool> should_explode;
+        QList<qreal> elapsed; // ms
+
+        qsizetype size() const { return elapsed.size(); }
+        void removeAt(qsizetype i);
+        void clear();
+    } shoots_;
+
+    // Records of melee pricks
+    struct MeleePricks{
+        QList<QLineF> rest_line;
+        QList<QLineF> key_line;
+        QList<QColor> color;
+        QList<qreal> width;
+        QList<qreal> duration; // ms
+        QList<qreal> elapsed; // ms
+
+        qsizetype size() const { return elapsed.size(); }
+        void removeAt(qsizetype i);
+        void clear();
+    } melee_pricks_;
+
+    // Records of texts
+    struct Texts{
+        QList<QString> text;
+        QList<QColor> color;
+        // Text is displayed at scene pos of anchor, or at pos if anchor is nullptr
+        QList<const QGraphicsItem*> anchor;
+        QList<QPointF> pos;
+        QList<qreal> elapsed; // ms
+
+        qsizetype size() const { return elapsed.size(); }
+        void removeAt(qsizetype i);
+        void clear();
+    } texts_;
+
+    QRectF rect_;
+
+    int max_effects_;
+
+    QFont text_font_;
+
+    bool isFull() const;
+
+public:
+
+    enum { Type = UserType + 1000 };
+
+    static constexpr const int DEFAULT_MAX_EFFECTS = 256;
+
+    explicit EffectsLayer(int max_effects = DEFAULT_MAX_EFFECTS, QGraphicsItem *parent = nullptr);
+
+    int type() const override;
+
+    QRectF boundingRect() const override;
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    /**
+     * Set rect (in item coordinates) that effects are displayed in, e.g. rect of field
+     */
+    void setRect(const QRectF& rect);
+
+    /**
+     * Add an effect, which starts at once
+     * @returns false if too many effects are displayed now, and the effect is dropped
+     */
+    bool add(const ShootParticle& particle);
+
+    bool add(const MeleePrickParticle& particle);
+
+    /**
+     * @param anchor item that text follows, nullptr if text is fixed at `pos`
+     * @param pos pos of text in scene, used only if anchor is nullptr
+     */
+    bool add(const SimpleTextParticle& particle, const QGraphicsItem* anchor, QPointF pos = QPointF());
+
+    /**
+     * Advance all effects by `time` (ms), and remove those finished
+     * Should be called once a frame
+     */
+    void advanceTime(qreal time);
+
+    /**
+     * Fix texts anchored to item at its current pos, so that they can outlive it
+     * Must be called before item is deleted
+     */
+    void releaseAnchor(const QGraphicsItem* item);
+
+    /**
+     * Returns number of effects displayed now
+     */
+    int size() const;
+
+    int getMaxEffects() const;
+
+    void setMaxEffects(int max_effects);
+
+    void clear();
+
+};
+
+#endif //AP_PROJ_EFFECTSLAYER_H
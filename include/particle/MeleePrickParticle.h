@@ -1,29 +1,26 @@
 #ifndef AP_PROJ_MELEEPRICKPARTICLE_H
 #define AP_PROJ_MELEEPRICKPARTICLE_H
 
-#include <QGraphicsLineItem>
-#include <QObject>
-#include <QPropertyAnimation>
+#include <QPointF>
+#include <QLineF>
+#include <QPen>
 
 /**
  * Visual effect of melee attack.
  * i.e. A line that can move forward / backward (prick) or "sweep"
  * e.g. attack of Knight
+ * It moves between restLine() and keyLine() and back
  */
-class MeleePrickParticle: public QObject, public QGraphicsLineItem{
-    Q_OBJECT
-    Q_PROPERTY(QLineF line_ READ line WRITE setLine)
+class MeleePrickParticle{
 
     qreal speed_ = 600; // px per second
 
-    QPointF attacker_pos_;
-    QPointF target_pos_;
+    QPointF attacker_pos_; // In scene coordinates
+    QPointF target_pos_; // In scene coordinates
 
-public:
-    using QGraphicsLineItem::QGraphicsLineItem;
+    QPen pen_;
 
-    enum { Type = UserType + 1002 };
-    int type() const override;
+public:
 
     void setSpeed(qreal speed);
 
@@ -31,7 +28,24 @@ public:
 
     void setTargetPos(QPointF target_pos);
 
-    void startAnimation();
+    void setPen(const QPen& pen);
+
+    QPen getPen() const;
+
+    /**
+     * Returns line at start and end of animation, i.e. 3/4 of the way from attacker to target
+     */
+    QLineF restLine() const;
+
+    /**
+     * Returns line at middle of animation, i.e. the last 3/4 of the way from attacker to target
+     */
+    QLineF keyLine() const;
+
+    /**
+     * Returns time (ms) of animation
+     */
+    qreal duration() const;
 
 };
 
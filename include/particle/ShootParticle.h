@@ -1,35 +1,31 @@
 #ifndef AP_PROJ_MOVINGPARTICLE_H
 #define AP_PROJ_MOVINGPARTICLE_H
 
-#include <QGraphicsEllipseItem>
-#include <QObject>
-#include <QPropertyAnimation>
+#include <QPointF>
+#include <QColor>
 
 /**
  * Visual effect of ranged attack (like a shoot).
  * i.e. A ball that can move toward specific direction
  * e.g. arrow of Elf
+ * Phase 1 takes moveDuration(), and phase 2 (explosion, if any) takes EXPLODE_DURATION
  */
-class ShootParticle: public QObject, public QGraphicsEllipseItem{
-    Q_OBJECT
-    Q_PROPERTY(QPointF pos_ READ pos WRITE setPos)
-    Q_PROPERTY(qreal opacity_ READ opacity WRITE setOpacity)
-    Q_PROPERTY(qreal scale_ READ scale WRITE setScale)
+class ShootParticle{
 
     qreal speed_ = 300; // px per second
 
-    QPointF start_pos_;
-    QPointF end_pos_;
+    QPointF start_pos_; // In scene coordinates
+    QPointF end_pos_; // In scene coordinates
+
+    QColor color_ = Qt::white;
 
     // Whether there is phase 2 animation:
     // bullet explodes, and fades at the same time
     bool should_explode_ = false;
 
 public:
-    explicit ShootParticle(QGraphicsItem *parent = nullptr);
 
-    enum { Type = UserType + 1001 };
-    int type() const override;
+    static constexpr const int EXPLODE_DURATION = 500; // ms
 
     void setSpeed(qreal speed);
 
@@ -40,7 +36,17 @@ public:
 
     void setShouldExplode(bool should_explode);
 
-    void startAnimation();
+    QPointF getStartPos() const;
+    QPointF getEndPos() const;
+
+    QColor getParticleColor() const;
+
+    bool shouldExplode() const;
+
+    /**
+     * Returns time (ms) of phase 1 animation, i.e. moving from start pos to end pos
+     */
+    qreal moveDuration() const;
 
 };
 
@@ -1,7 +1,7 @@
 #ifndef AP_PROJ_SIMPLETEXTPARTICLE_H
 #define AP_PROJ_SIMPLETEXTPARTICLE_H
 
-#include <QGraphicsSimpleTextItem>
+#include <QString>
 #include <QColor>
 
 /**
@@ -9,25 +9,24 @@
  * The animation an be divided into 2 phases
  * P1: Text appears and then becomes bigger
  * P2: Text's size is fixed and text becomes transparent
- *
- * @inherit QObject, QGraphicsSimpleTextItem
  */
+class SimpleTextParticle{
 
-class SimpleTextParticle: public QObject, public QGraphicsSimpleTextItem{
-    Q_OBJECT
-    Q_PROPERTY(qreal opacity_ READ opacity WRITE setOpacity)
-    Q_PROPERTY(qreal scale_ READ scale WRITE setScale)
+    QString text_;
+    QColor color_ = Qt::white;
 
 public:
 
-    explicit SimpleTextParticle(const QString &text, QGraphicsItem *parent = nullptr);
+    static constexpr const int SCALE_DURATION = 500; // ms, phase 1
+    static constexpr const int FADE_DURATION = 600; // ms, phase 2
 
-    enum { Type = UserType + 1003 };
-    int type() const override;
+    explicit SimpleTextParticle(const QString &text);
 
     void setTextColor(QColor color);
 
-    void startAnimation();
+    QString getText() const;
+
+    QColor getTextColor() const;
 };
 
 #endif //AP_PROJ_SIMPLETEXTPARTICLE_H
@@ -0,0 +1,99 @@
+#ifndef AP_PROJ_ATTACKSCHEDULE_H
+#define AP_PROJ_ATTACKSCHEDULE_H
+
+#include <QList>
+#include <QtGlobal>
+#include "SimEntity.h"
+
+/**
+ * Schedule of entities by tick they are due to try an attack, refer to Simulation::scheduleAttack()
+ * Used to visit only entities due in a tick, rather than polling all of them
+ * Entities due in next tick (e.g. ready but having no target, which are due in every tick) are kept in a list,
+ * and others are kept in a min-heap, so that the common case needs no sifting.
+ * Note:
+ * * Entities due in the same tick are taken in ascending order of id,
+ *   i.e. the same order as they are added into Simulation;
+ * * Position of an entity is stored in SimEntity::schedule_idx,
+ *   so an entity can be in one schedule at most, and it can be rescheduled or removed in O(log n).
+ */
+class AttackSchedule{
+
+    // SimEntity::schedule_idx of entities in lists of next tick, -1 for none, and index in heap_ otherwise
+    static constexpr const int IN_LIST = -2;
+
+    struct Entry{
+        qint64 tick;
+        SimEntity* entity;
+
+        inline bool operator<(const Entry& other) const{
+            return tick != other.tick ? tick < other.tick : entity->id < other.entity->id;
+        }
+    };
+
+    // Entity is nullptr if it has been removed, so that removing needs no shifting
+    struct ListEntry{
+        int id;
+        SimEntity* entity;
+    };
+
+    qint64 last_tick_ = 0; // Tick of last takeDue()
+
+    QList<Entry> heap_;
+
+    // Entities due in last_tick_, sorted by id; those before due_pos_ have been taken
+    QList<ListEntry> due_;
+    qsizetype due_pos_ = 0;
+
+    // Entities due in next tick, sorted by id
+    QList<ListEntry> next_;
+
+    void place(qsizetype idx, const Entry& entry);
+
+    void siftUp(qsizetype idx);
+
+    void siftDown(qsizetype idx);
+
+    void removeFromHeap(SimEntity* entity);
+
+    /**
+     * Find entry of entity in list sorted by id, nullptr if none
+     */
+    static ListEntry* findInList(QList<ListEntry>& list, qsizetype begin, const SimEntity* entity);
+
+    /**
+     * Called when a new tick begins, entities due in next tick become due now
+     */
+    void advanceTo(qint64 tick);
+
+public:
+
+    /**
+     * Returns the first tick that entities have not been taken in, i.e. tick of last takeDue() + 1
+     */
+    qint64 nextTick() const;
+
+    /**
+     * Make entity due at `tick`, whether it's in the schedule or not
+     * If `tick` < nextTick(), it's due at nextTick()
+     */
+    void schedule(SimEntity* entity, qint64 tick);
+
+    /**
+     * Remove entity from the schedule
+     * If entity is not in any schedule, just ignore it
+     */
+    void remove(SimEntity* entity);
+
+    /**
+     * Take the first entity due at or before `tick` out of the schedule, nullptr if there is none
+     * `tick` should not be less than that of last call
+     */
+    SimEntity* takeDue(qint64 tick);
+
+    void clear();
+
+    qsizetype size() const;
+
+};
+
+#endif //AP_PROJ_ATTACKSCHEDULE_H
@@ -0,0 +1,75 @@
+#ifndef AP_PROJ_LEVELPACK_H
+#define AP_PROJ_LEVELPACK_H
+
+#include <QtEndian>
+#include <QtGlobal>
+
+/**
+ * Layout of compiled level file (*.aplv), a binary counterpart of a level directory
+ * Simulation::loadLevelFromPack() maps the file into memory and reads sections in place,
+ * so nothing is parsed or allocated per line as loading *.dat files does.
+ * Converted from a level directory by ap_levelpack, refer to Simulation::saveLevelToPack().
+ *
+ * All integers are little endian. Sections follow the header, each aligned to 8 bytes:
+ * - tiles: num_rows * num_cols Tile, row-major
+ * - start areas, then Protection Objectives: AreaIndex, in order of adding (order of start areas matters for random)
+ * - character options: num_character_options bytes, each an EntityKind
+ * - spawns: num_spawns Spawn, by ascending order of arrival time
+ */
+struct LevelPack{
+
+    static constexpr const quint32 MAGIC = 0x564c5041; // "APLV"
+    // Should be increased if layout, EntityKind or ordinals of buffs are changed
+    static constexpr const quint16 VERSION = 1;
+
+    struct Header{
+        quint32_le magic;
+        quint16_le version;
+        quint16_le num_buffs; // BuffUtil::NUM_BUFFS when written, masks of spawns depend on it
+        qint32_le num_rows;
+        qint32_le num_cols;
+        qint32_le health_points;
+        quint32_le num_start_areas;
+        quint32_le num_protect_areas;
+        quint32_le num_character_options;
+        quint32_le num_spawns;
+        quint32_le reserved;
+        // Offsets (bytes) of sections from beginning of file
+        quint64_le tiles_offset;
+        quint64_le area_indices_offset;
+        quint64_le character_options_offset;
+        quint64_le spawns_offset;
+    };
+
+    struct Tile{
+        quint16_le to_codes; // Refer to SimArea::to_codes
+        quint8 type; // SimArea::Type
+        quint8 reserved;
+    };
+
+    struct AreaIndex{
+        qint32_le row_idx;
+        qint32_le col_idx;
+    };
+
+    struct Spawn{
+        qint32_le arrival_time; // ms
+        quint32_le buff_mask; // Refer to BuffUtil::buffToMask()
+        quint8 kind; // EntityKind
+        quint8 reserved[3];
+    };
+
+    static constexpr const qint64 SECTION_ALIGNMENT = 8;
+
+    static constexpr qint64 alignSection(qint64 offset){
+        return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    }
+
+};
+
+static_assert(sizeof(LevelPack::Header) == 72);
+static_assert(sizeof(LevelPack::Tile) == 4);
+static_assert(sizeof(LevelPack::AreaIndex) == 8);
+static_assert(sizeof(LevelPack::Spawn) == 12);
+
+#endif //AP_PROJ_LEVELPACK_H
@@ -0,0 +1,77 @@
+#ifndef AP_PROJ_PARALLELUTIL_H
+#define AP_PROJ_PARALLELUTIL_H
+
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * Utility class running loops on worker threads of QThreadPool::globalInstance()
+ * Used by Simulation for phases in which entities are updated independently, e.g. moving monsters.
+ * Note: Body of loop must only write data of its own index, reading shared data is fine.
+ * Since no two indices share data written, result does not depend on how the loop is split.
+ */
+class ParallelUtil{
+
+    static std::atomic<int> max_threads_;
+
+public:
+
+    // Loops shorter than this are run on calling thread only, for starting threads costs more
+    static constexpr const qsizetype MIN_PARALLEL_SIZE = 256;
+    // Indices are handed out to threads in chunks of this size
+    static constexpr const qsizetype CHUNK_SIZE = 64;
+
+    /**
+     * Max number of threads used by a loop, including calling thread
+     * By default it's QThread::idealThreadCount()
+     */
+    static int maxThreads();
+
+    /**
+     * 1 to run all loops on calling thread
+     */
+    static void setMaxThreads(int num_threads);
+
+    /**
+     * Call func(i) for each i in [0, n), and return after all of them are done
+     * Calling thread takes part in the loop, so it works even if no worker is free.
+     */
+    template<class Func>
+    static void forEach(qsizetype n, const Func& func){
+        int num_threads = maxThreads();
+        if(n < MIN_PARALLEL_SIZE || num_threads <= 1){
+            for(qsizetype i = 0; i < n; ++i)
+                func(i);
+            return;
+        }
+
+        std::atomic<qsizetype> next = 0;
+        auto run_chunks = [&next, n, &func](){
+            for(qsizetype begin = next.fetch_add(CHUNK_SIZE); begin < n; begin = next.fetch_add(CHUNK_SIZE)){
+                qsizetype end = qMin(begin + CHUNK_SIZE, n);
+                for(qsizetype i = begin; i < end; ++i)
+                    func(i);
+            }
+        };
+
+        // Only free workers are used, no task waits in queue of pool
+        QSemaphore done;
+        int num_workers = 0;
+        int max_workers = static_cast<int>(qMin<qsizetype>(num_threads - 1, (n - 1) / CHUNK_SIZE));
+        for(; num_workers < max_workers; ++num_workers){
+            bool started = QThreadPool::globalInstance()->tryStart([&run_chunks, &done](){
+                run_chunks();
+                done.release();
+            });
+            if(!started)
+                break;
+        }
+        run_chunks();
+        done.acquire(num_workers);
+    }
+
+};
+
+#endif //AP_PROJ_PARALLELUTIL_H
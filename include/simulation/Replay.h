@@ -0,0 +1,37 @@
+#ifndef AP_PROJ_REPLAY_H
+#define AP_PROJ_REPLAY_H
+
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+#include "SimCommand.h"
+
+/**
+ * Everything needed to re-run a game exactly: level, seed of random generator and commands of player
+ * Simulation runs at a fixed timestep, so running commands at the same ticks leads to the same game.
+ * It's saved as a compact binary file (11 bytes per command).
+ */
+struct Replay{
+
+    static constexpr const quint32 MAGIC = 0x41505250; // "APRP"
+    static constexpr const quint16 VERSION = 1;
+
+    QString level_path; // Directory of level, refer to Simulation::loadLevelFromFile()
+
+    quint32 seed = 0;
+
+    QList<SimCommand> commands; // Sorted by tick
+
+    /**
+     * Exception will be thrown if file cannot be written
+     */
+    void saveToFile(const QString& file_path) const;
+
+    /**
+     * Exception will be thrown if file cannot be read, or it's not a valid replay
+     */
+    static Replay loadFromFile(const QString& file_path);
+
+};
+
+#endif //AP_PROJ_REPLAY_H
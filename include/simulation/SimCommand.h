@@ -0,0 +1,37 @@
+#ifndef AP_PROJ_SIMCOMMAND_H
+#define AP_PROJ_SIMCOMMAND_H
+
+#include <QPoint>
+#include <QtGlobal>
+#include "Buff.h"
+#include "SimEntity.h"
+
+/**
+ * Input of player to a Simulation, e.g. placing a character
+ * Commands are run by Simulation::execute(), which records them along with tick number,
+ * so that a game can be replayed exactly, refer to Replay.
+ * Characters are referred to by the area they're placed in, for ids differ between runs.
+ */
+struct SimCommand{
+
+    enum class Type : quint8{
+        // Place character `kind` in area `area_idx`
+        PLACE_CHARACTER,
+        // Remove character in area `area_idx`
+        REMOVE_CHARACTER,
+        // Add `buff` to character in area `area_idx` if not having it, remove it otherwise
+        TOGGLE_BUFF,
+    };
+
+    Type type = Type::PLACE_CHARACTER;
+
+    QPoint area_idx;
+
+    EntityKind kind = EntityKind::ELF;
+
+    Buff buff = Buff::NONE;
+
+    qint64 tick = 0; // Number of ticks run before the command, set by Simulation
+};
+
+#endif //AP_PROJ_SIMCOMMAND_H
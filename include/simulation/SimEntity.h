@@ -0,0 +1,198 @@
+#ifndef AP_PROJ_SIMENTITY_H
+#define AP_PROJ_SIMENTITY_H
+
+#include <QPointF>
+#include <QPoint>
+#include <QPair>
+#include "BuffSet.h"
+#include "BuffUtil.h"
+#include "Element.h"
+
+/**
+ * Kinds of entities known by the simulation core.
+ * Each kind has a graphical counterpart created by GameField,
+ * e.g. EntityKind::ELF is displayed by Elf.
+ */
+enum class EntityKind{
+    // Characters
+    ELF,
+    KNIGHT,
+
+    // Monsters
+    BOAR,
+};
+
+/**
+ * Plain-data state of an entity (character or monster) in the simulation.
+ * It holds everything game rules need, and nothing about how the entity is drawn.
+ * Rules themselves (attack, move, ...) are in Simulation.
+ * Note:
+ * * Use Simulation to create entities, so that each of them gets a unique id;
+ * * damage, recharge_time and attack_range should be set if you want to make a valid attack
+ * * If one entity cannot be attacked, can_be_attacked should be set false
+ */
+struct SimEntity{
+
+    using Direction = QPair<int, int>;
+    using AreaIndex = QPoint;
+
+    static constexpr const int ON_GRASS = 0b01;
+    static constexpr const int ON_ROAD = 0b10;
+
+    // CD (ms) for skill, e.g. flash (when having "EVER-CHANGING" buff)
+    static constexpr const int SKILL_CD = 10 * 1000;
+
+    // Bits of dirty, each raised when a part of status displayed by the view changes
+    static constexpr const int DIRTY_HEALTH = 0b001;
+    static constexpr const int DIRTY_BUFFS = 0b010;
+    static constexpr const int DIRTY_AURA = 0b100;
+    static constexpr const int DIRTY_ALL = DIRTY_HEALTH | DIRTY_BUFFS | DIRTY_AURA;
+
+    int id = 0; // Unique in a Simulation, used by the view to find its graphics item
+
+    EntityKind kind = EntityKind::BOAR;
+
+    // Position (px) of top-left corner, in the same coordinates as areas of field
+    QPointF pos;
+    // Position before last tick, so that view can interpolate between it and pos
+    QPointF prev_pos;
+
+    int grid_cell = -1; // Cell of SpatialGrid holding the entity, -1 if none
+
+    // Fields below are read for every candidate of target search along with id and pos, so they are kept close to them
+    // Use setHealth() to change health of an entity in game, so that the view is notified
+    int health = 1;
+    int max_health = 1;
+
+    bool can_be_attacked = true; // Some entities, such as ELf (on grass), cannot be attacked
+
+    int damage = 0; // Damage made per attack
+
+    int recharge_time = 0; // Time (ms) to recharge before an attack
+
+    // Time (ms) that the entity has recharged since last attack, up to tick recharged_tick
+    // It's brought up to date only when needed, refer to Simulation::updateRecharged()
+    int recharged = 0;
+    qint64 recharged_tick = 0;
+    int recharge_rate = 0; // Time (ms) recharged per tick after recharged_tick, refer to Simulation::rechargeRate()
+
+    int schedule_idx = -1; // Position in AttackSchedule, -1 if none
+
+    qreal attack_range = 0; // Attack range (num of area size)
+
+    // buffs of this entity, along with time (ms) each one expires at, refer to Simulation::status_time_
+    BuffSet buffs;
+
+    // Refer to the design in Genshin Impact
+    // Element aura is created through an elemental attack
+    // For simplicity, only one aura is allowed
+    // Use setElementAura() to change it in game, so that the view is notified
+    Element element_aura = Element::NONE;
+
+    // DIRTY_* bits raised since the view displayed the entity last time
+    // A new entity has never been displayed, so all of them are raised
+    // Cleared by Simulation::clearDirtyFlags()
+    int dirty = DIRTY_ALL;
+
+    // Time (ms) since which continuous damage (e.g. corrosion) is counted, refer to Simulation::status_time_
+    // Once 1000(ms) has passed since it, do damage, and it moves on by 1000(ms)
+    // Note: it's reset when damage rate goes up from 0, refer to Simulation::buffsChanged()
+    qint64 continuous_damage_time = 0;
+
+    // Position in TimingWheel (wheel_slot is -1 if none), and time (ms) the entity is due in it
+    int wheel_slot = -1;
+    int wheel_pos = 0;
+    qint64 wheel_time = 0;
+
+    // Serial number of the last attack that hit the entity, so an AOE hits it once at most, refer to Simulation::attacked()
+    qint64 hit_serial = 0;
+
+    // Below are used by characters only
+
+    // if area_cond & ON_GRASS: this character can be placed on grass
+    // if area_cond & ON_ROAD: this character can be placed on road
+    int area_cond = 0;
+    AreaIndex area_idx; // Area that the character is placed in
+
+    // Below are used by monsters only
+
+    Direction direction = qMakePair(0, 0);
+    qreal speed = 10.0; // num of px per second to move
+
+    // Recharged val (ms) for using skill, up to time skill_recharged_time (refer to Simulation::status_time_)
+    // It's brought up to date only when skill is tried, refer to Simulation::tryFlash()
+    int skill_recharged = 0;
+    qint64 skill_recharged_time = 0;
+
+    /**
+     * Returns a new entity of given kind, with its attributes set
+     * Id is not set, refer to Simulation
+     */
+    static SimEntity* create(EntityKind kind);
+
+    static bool isCharacterKind(EntityKind kind);
+
+    static bool isMonsterKind(EntityKind kind);
+
+    bool isCharacter() const;
+
+    bool isMonster() const;
+
+    int getDamage() const;
+
+    int getHealth() const;
+
+    /**
+     * Set health, and raise DIRTY_HEALTH if it's changed
+     */
+    void setHealth(int val);
+
+    bool isAlive() const;
+
+    /**
+     * Returns if the entity is ready to make an attack
+     * i.e. recharged >= recharge_time
+     * Note: recharged should be brought up to date first
+     */
+    bool readyToAttack() const;
+
+    qreal getSpeed() const;
+
+    /**
+     * Returns true if character can be placed on area with `cond`
+     */
+    bool testAreaCond(int cond) const;
+
+    /**
+     * Add buff to the entity, whose duration is `duration`
+     * If buff exists, add `duration` to its duration left
+     * @param time current time (ms) of the clock buffs expire by, refer to Simulation::status_time_
+     */
+    void addBuff(Buff buff, int duration, qint64 time);
+
+    /**
+     * Remove buff of the entity
+     * If entity does not have the given buff, just ignore it (no exception will be thrown)
+     */
+    void removeBuff(Buff buff);
+
+    /**
+     * Returns if the entity has specific buff
+     */
+    inline bool hasBuff(Buff buff) const{
+        return buffs.contains(buff);
+    }
+
+    /**
+     * Set element aura, and raise DIRTY_AURA if it's changed
+     */
+    void setElementAura(Element aura);
+
+    /**
+     * Returns elemental infusion buff if existing, Buff::NONE otherwise
+     */
+    Buff getElementInfusionBuff() const;
+
+};
+
+#endif //AP_PROJ_SIMENTITY_H
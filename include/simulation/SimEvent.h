@@ -0,0 +1,42 @@
+#ifndef AP_PROJ_SIMEVENT_H
+#define AP_PROJ_SIMEVENT_H
+
+#include <QtGlobal>
+#include "Buff.h"
+#include "Element.h"
+
+/**
+ * Something happened during a tick of Simulation, which the view may want to display.
+ * Entities are referred to by id, for they may have been deleted when the event is handled.
+ */
+struct SimEvent{
+
+    enum class Type{
+        // Entity `source_id` attacked entity `target_id`, infused with `element`
+        ATTACK,
+        // Entity `target_id` got de-buff `buff` from an attack
+        BUFF_APPLIED,
+        // Element reaction `reaction` happened on entity `target_id`, displayed as text effect
+        TEXT_EFFECT,
+        // Monster `target_id` was killed
+        MONSTER_KILLED,
+        // Entity `target_id` was removed from the field, either dead or having reached Protection Objective
+        ENTITY_REMOVED,
+    };
+
+    Type type;
+
+    int source_id = 0;
+    int target_id = 0;
+
+    Element element = Element::NONE;
+
+    Buff buff = Buff::NONE;
+
+    // Text and color are looked up by the view, so an event holds no string
+    Reaction reaction = Reaction::NONE;
+
+    qint64 time = 0; // Game time (ms) of the tick when it happened, set by Simulation
+};
+
+#endif //AP_PROJ_SIMEVENT_H
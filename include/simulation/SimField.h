@@ -0,0 +1,161 @@
+#ifndef AP_PROJ_SIMFIELD_H
+#define AP_PROJ_SIMFIELD_H
+
+#include <QList>
+#include <QBitArray>
+#include <QPair>
+#include <QPoint>
+#include <QPointF>
+#include <QtGlobal>
+
+struct SimEntity;
+
+/**
+ * Plain-data state of one area of the field
+ * Counterpart of Area (Grass and Road) in the simulation core
+ * It's kept small and free of allocation, since areas are stored contiguously and read by monsters every tick.
+ */
+struct SimArea{
+
+    using Direction = QPair<int, int>;
+
+    enum class Type{
+        GRASS,
+        ROAD,
+    };
+
+    Type type = Type::GRASS;
+
+    // Character or other blocker placed in this area, nullptr if none
+    // Not owned by the area
+    SimEntity* occupant = nullptr;
+
+    // Used by roads only
+    // Map from "from direction" to "to direction", packed as direction codes
+    // Suppose a monster come from upside (direction{0, 1}),
+    // and it should go left (direction{-1, 0}),
+    // then "to direction" of {0, 1} is {-1, 0}
+    // Code of "to direction" for k-th "from direction" is in bits [3k, 3k + 3), refer to directionToCode()
+    // By default, "to direction" of any direction is {0, 0}
+    quint16 to_codes = 0;
+
+    /**
+     * Set "to direction" of a road for monsters coming from `from`
+     * Exception will be thrown if `from` or `to` is not one of the 4 directions ({0, 0} is allowed for `to`)
+     */
+    void setDirection(const Direction& from, const Direction& to);
+
+    Direction getToDirection(const Direction& from) const;
+
+    /**
+     * Returns code of direction, i.e. 0 for {0, 0},
+     * and 1~4 for {-1, 0}, {0, 1}, {1, 0}, {0, -1} respectively
+     * -1 if it's not a valid direction
+     */
+    static inline int directionToCode(const Direction& direction){
+        if(qAbs(direction.first) + qAbs(direction.second) > 1)
+            return -1;
+        switch (direction.first * 3 + direction.second) {
+            case 0: return 0;
+            case -3: return 1;
+            case 1: return 2;
+            case 3: return 3;
+            case -1: return 4;
+            default: return -1;
+        }
+    }
+
+    static inline Direction codeToDirection(int code){
+        static const Direction directions[5] = {{0, 0}, {-1, 0}, {0, 1}, {1, 0}, {0, -1}};
+        return directions[code];
+    }
+};
+
+/**
+ * Grid of areas, along with start areas and Protection Objectives
+ * Area with index {row_idx, col_idx} is at pos {area_size * col_idx, area_size * row_idx}
+ * Areas are stored in a flat row-major array, and start areas and Protection Objectives are marked in bitmaps as well,
+ * so that looking them up needs no hashing or scanning.
+ */
+class SimField{
+
+public:
+
+    using AreaIndex = QPoint;
+
+    static constexpr const qreal REAL_COMPENSATION = 0.0000001;
+
+private:
+
+    qreal area_size_ = 0; // px
+
+    int num_rows_ = 0;
+    int num_cols_ = 0;
+
+    // Row-major, i.e. area {row_idx, col_idx} is areas_[row_idx * num_cols_ + col_idx]
+    QList<SimArea> areas_;
+
+    QList<AreaIndex> start_areas_idx_;
+    QList<AreaIndex> protect_areas_idx_;
+
+    // Bit (row_idx * num_cols_ + col_idx) is set if area is in lists above
+    QBitArray start_bitmap_;
+    QBitArray protect_bitmap_;
+
+    inline int flatIndex(const AreaIndex& idx) const{
+        return idx.x() * num_cols_ + idx.y();
+    }
+
+public:
+
+    explicit SimField(qreal area_size = 0);
+
+    /**
+     * Clear the field, and fill it with grass of given size
+     */
+    void reset(int num_rows, int num_cols);
+
+    qreal getAreaSize() const;
+
+    void setAreaSize(qreal size);
+
+    int numRows() const;
+
+    int numCols() const;
+
+    /**
+     * Returns if idx is in range of the field
+     */
+    bool contains(const AreaIndex& idx) const;
+
+    SimArea& area(const AreaIndex& idx);
+
+    const SimArea& area(const AreaIndex& idx) const;
+
+    void addStartArea(const AreaIndex& idx);
+
+    void addProtectArea(const AreaIndex& idx);
+
+    const QList<AreaIndex>& startAreasIdx() const;
+
+    const QList<AreaIndex>& protectAreasIdx() const;
+
+    bool isStartArea(const AreaIndex& idx) const;
+
+    bool isProtectArea(const AreaIndex& idx) const;
+
+    /**
+     * Returns pos (px) of the top-left corner of area
+     */
+    QPointF indexToPos(const AreaIndex& idx) const;
+
+    /**
+     * Returns {row_idx, col_idx} of the area which pos is at.
+     * If pos is out of rect of field, a valid pair will still be returned.
+     * -1 <= row_idx <= num_rows, -1 <= col_idx <= num_cols.
+     */
+    AreaIndex posToIndex(QPointF pos) const;
+
+};
+
+#endif //AP_PROJ_SIMFIELD_H
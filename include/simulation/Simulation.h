@@ -0,0 +1,548 @@
+#ifndef AP_PROJ_SIMULATION_H
+#define AP_PROJ_SIMULATION_H
+
+#include <QList>
+#include <QQueue>
+#include <QPair>
+#include <QPoint>
+#include <QPointF>
+#include <QRandomGenerator>
+#include <QString>
+#include "ActionAttack.h"
+#include "AttackSchedule.h"
+#include "SimCommand.h"
+#include "SimEntity.h"
+#include "SimField.h"
+#include "SimEvent.h"
+#include "SpatialGrid.h"
+#include "TickProfiler.h"
+#include "TimingWheel.h"
+
+/**
+ * Headless simulation core of a level.
+ * It holds field, entities and monster queue as plain data, and runs all game rules on them.
+ * Nothing here needs a QApplication, pixmaps or a scene,
+ * so a level can be run without displaying it (e.g. balance checks).
+ * GameField is the view of a Simulation: it mirrors state into graphics items after each tick.
+ */
+class Simulation{
+
+public:
+
+    using Direction = QPair<int, int>;
+    using AreaIndex = QPoint;
+
+    enum class State{
+        RUNNING,
+        WON,
+        LOST,
+    };
+
+    // Bits of dirtyFlags(), each raised when a part of status displayed by the view changes
+    static constexpr const int DIRTY_HEALTH_POINTS = 0b01;
+    static constexpr const int DIRTY_MONSTER_QUEUE = 0b10;
+    static constexpr const int DIRTY_ALL = DIRTY_HEALTH_POINTS | DIRTY_MONSTER_QUEUE;
+
+    // Max number of entities hit by AOE of one attack by default, refer to setMaxAoeTargets()
+    static constexpr const int DEFAULT_MAX_AOE_TARGETS = 32;
+
+private:
+
+    SimField field_;
+
+    int refresh_interval_ = 0; // Time (ms) of one tick
+
+    qint64 game_time_ = 0; // time (ms) since game start; It should be updated by tick()
+
+    qint64 tick_count_ = 0; // Number of ticks run
+
+    // All random numbers of game rules come from random_,
+    // so that a game can be re-run with the same seed, refer to Replay
+    quint32 seed_;
+    QRandomGenerator random_;
+
+    int next_entity_id_ = 1;
+
+    /**
+     * Record of a monster to come, which is created only when it arrives, refer to generateMonsters()
+     * So a level with a long list of monsters costs little memory and time to load.
+     */
+    struct MonsterSpawn{
+        EntityKind kind;
+        int arrival_time; // ms
+        quint32 buff_mask; // Buffs lasting 100s since arrival, refer to BuffUtil::buffToMask()
+    };
+
+    // Sorted by ascending order of arrival time
+    QQueue<MonsterSpawn> monster_que_;
+
+    QList<SimEntity*> monsters_;
+    QList<SimEntity*> characters_;
+
+    // Last tick whose status (buffs, recharge...) of entities has been updated, refer to updateEntityStatus()
+    qint64 status_tick_ = 0;
+    // Sum of refresh intervals (ms) of ticks till status_tick_, the clock buffs expire by
+    // Unlike game_time_, it's moved on by updateEntityStatus(), so a buff added at any point of a tick lasts the same
+    qint64 status_time_ = 0;
+
+    // Entities by time their status is due to change (e.g. a buff expires), refer to scheduleStatus()
+    // Entity should be removed along with lists above
+    TimingWheel status_wheel_;
+
+    // Entities by tick they are due to try an attack, refer to scheduleAttack()
+    // Entity should be inserted and removed along with lists above
+    AttackSchedule character_attacks_;
+    AttackSchedule monster_attacks_;
+
+    // Buffers of resolveAttacks(), kept to save allocation per tick
+    // Entities due to attack, and targets they selected (nullptr if none)
+    QList<SimEntity*> attackers_;
+    QList<SimEntity*> selected_targets_;
+
+    // Buffers of attacked(), kept to save allocation per attack
+    QList<ActionAttack> aoe_worklist_;
+    QList<SimEntity*> aoe_nearby_;
+    // Serial number of the last attack made, refer to SimEntity::hit_serial
+    qint64 attack_serial_ = 0;
+
+    // Number of attacks received (AOE included) since construction, refer to getHitCount()
+    qint64 num_hits_ = 0;
+
+    // Entities bucketed by pos, used to find targets in range
+    // Entity should be inserted, moved and removed along with lists above
+    SpatialGrid monster_grid_;
+    SpatialGrid character_grid_;
+
+    // Characters that can be placed in this level
+    QList<EntityKind> character_options_;
+
+    int health_points_ = 1;
+
+    // Max number of entities hit by AOE of one attack (the target attacked first not included), refer to attacked()
+    int max_aoe_targets_ = DEFAULT_MAX_AOE_TARGETS;
+
+    State state_ = State::RUNNING;
+
+    // Events are only recorded when someone (e.g. GameField) is going to take them
+    bool record_events_ = false;
+    QList<SimEvent> events_;
+
+    // Commands are only recorded when someone (e.g. GameField) is going to save them
+    bool record_commands_ = false;
+    QList<SimCommand> commands_;
+
+    // Commands of a replay, run by tick() at the ticks they were recorded
+    bool replaying_ = false;
+    QQueue<SimCommand> replay_commands_;
+
+    // DIRTY_* bits raised since the view displayed status last time
+    int dirty_ = DIRTY_ALL;
+
+    // Time of each phase in tick() is recorded if set, not owned
+    TickProfiler* profiler_ = nullptr;
+
+public:
+
+    /**
+     * @param area_size size (px) of an area, which is also the unit of attack range
+     * @param refresh_interval time (ms) of one tick
+     */
+    Simulation(qreal area_size, int refresh_interval);
+
+    ~Simulation();
+
+    Simulation(const Simulation&) = delete;
+
+    Simulation& operator=(const Simulation&) = delete;
+
+    /**
+     * Load data from files
+     * dir_path should contain 4 files:
+     * field.dat: data of field
+     * characters.dat: characters can be used
+     * monsters.dat: monsters that will appear in this level, along with time of arrival
+     * level_setting.dat: other settings of this level, such as life points of player
+     * @param dir_path const QString& directory having data of field, monsters and characters cna be used
+     * If it's a file rather than a directory, it's loaded as a compiled level by loadLevelFromPack()
+     */
+    void loadLevelFromFile(const QString& dir_path);
+
+    /**
+     * Load a compiled level file (*.aplv), refer to LevelPack for its layout
+     * File is mapped into memory, and sections are read in place.
+     * Exception will be thrown if file cannot be read, or it's not a valid level pack
+     */
+    void loadLevelFromPack(const QString& file_path);
+
+    /**
+     * Write current level, i.e. field, characters, monster queue and health points to a compiled level file
+     * Should be called before game starts, e.g. right after loadLevelFromFile()
+     * Exception will be thrown if game has started, or file cannot be written
+     */
+    void saveLevelToPack(const QString& file_path) const;
+
+    /**
+     * Load level of another simulation, i.e. field, characters, monster queue and health points
+     * Used to run many games on one level without parsing it again, e.g. by ap_eval
+     * `level` is only read, so it can be shared by simulations on many threads.
+     * Exception will be thrown if game of `level` has started, or there are entities on current field
+     */
+    void loadLevelFrom(const Simulation& level);
+
+    // Called by loadLevelFromFile()
+    void loadFieldFromFile(const QString& file_path);
+
+    // Called by loadLevelFromFile()
+    void loadCharacterOptionFromFile(const QString& file_path);
+
+    // Called by loadLevelFromFile()
+    void loadMonsterQueueFromFile(const QString& file_path);
+
+    // Called by loadLevelFromFile()
+    void loadLevelSettingFromFile(const QString& file_path);
+
+    /**
+     * Use `field`, e.g. one built in memory by a level generator
+     * Area size of simulation is kept, and the one of `field` is ignored
+     * Exception will be thrown if there are entities on current field
+     */
+    void setField(const SimField& field);
+
+    /**
+     * Add a monster of given kind to the end of monster queue, with `buffs` lasting 100s since it arrives
+     * Only a record is kept, and the monster is created when it arrives
+     * Exception will be thrown if `kind` is not a monster,
+     * or `arrival_time` (ms) is earlier than that of the last monster in queue
+     */
+    void addMonsterArrival(EntityKind kind, int arrival_time, const QList<Buff>& buffs = {});
+
+    /**
+     * Same as above, with buffs given as a mask (refer to BuffUtil::buffToMask())
+     */
+    void addMonsterArrival(EntityKind kind, int arrival_time, quint32 buff_mask);
+
+    void setHealthPoints(int health_points);
+
+    int getMaxAoeTargets() const;
+
+    /**
+     * Set max number of entities hit by AOE of one attack, including those by Swirl on the way
+     * Entities nearer to the target (in fewer transmits) are hit first, 0 to turn AOE off
+     * Exception will be thrown if it's negative
+     */
+    void setMaxAoeTargets(int max_targets);
+
+    /**
+     * Run one tick of the game.
+     * All rules are applied in fixed order, for more, please refer to implementation
+     * Nothing happens if game has ended.
+     */
+    void tick();
+
+    int getRefreshInterval() const;
+
+    void setRefreshInterval(int interval);
+
+    const SimField& field() const;
+
+    qint64 getGameTime() const;
+
+    qint64 getTickCount() const;
+
+    /**
+     * Returns number of attacks received (AOE included) since construction
+     * Used by benchmark to tell cost per hit
+     */
+    qint64 getHitCount() const;
+
+    quint32 getSeed() const;
+
+    /**
+     * Reset random generator with `seed`
+     * Should be called before game starts, e.g. to run a replay
+     */
+    void setSeed(quint32 seed);
+
+    State getState() const;
+
+    int getHealthPoints() const;
+
+    int getMonsterQueueSize() const;
+
+    const QList<SimEntity*>& monsters() const;
+
+    const QList<SimEntity*>& characters() const;
+
+    const QList<EntityKind>& characterOptions() const;
+
+    /**
+     * Run a command of player, e.g. placing a character
+     * Player input should always come through here (rather than placeCharacter() etc.), so that it can be recorded
+     * Nothing happens if there is no character in area for REMOVE_CHARACTER or TOGGLE_BUFF
+     * @returns the character placed or having buff toggled, nullptr if none
+     */
+    SimEntity* execute(const SimCommand& command);
+
+    void setRecordCommands(bool record);
+
+    /**
+     * Returns commands executed since recording started, with tick number set
+     */
+    const QList<SimCommand>& commands() const;
+
+    /**
+     * Run `commands` (sorted by tick) in following ticks, at the same points as they were recorded
+     * Should be called before game starts, after setSeed() with seed of the replay
+     */
+    void startReplay(const QList<SimCommand>& commands);
+
+    /**
+     * Returns if a replay is running, when player input should be ignored
+     */
+    bool isReplaying() const;
+
+    /**
+     * Place a new character of given kind in area
+     * @returns the character placed, or nullptr if area is occupied or not suitable for it
+     */
+    SimEntity* placeCharacter(EntityKind kind, const AreaIndex& area_idx);
+
+    /**
+     * Remove specific character, and delete it
+     * Note: Statement of area holding the character is reset
+     */
+    void removeCharacter(SimEntity* character);
+
+    /**
+     * Returns character in specific area, nullptr if there is none (or area is out of range)
+     */
+    SimEntity* getCharacterInArea(const AreaIndex& area_idx) const;
+
+    void setRecordEvents(bool record);
+
+    /**
+     * Returns events happened since last call, and clear them
+     */
+    QList<SimEvent> takeEvents();
+
+    /**
+     * Record time of tick() and each phase of it in `profiler` (not owned), nullptr to stop
+     */
+    void setProfiler(TickProfiler* profiler);
+
+    /**
+     * Returns DIRTY_* bits raised since last call of clearDirtyFlags()
+     * Dirty bits of each entity are in SimEntity::dirty
+     */
+    int dirtyFlags() const;
+
+    /**
+     * Clear dirty bits of simulation and all entities on field
+     * Called by the view once it has displayed all changes
+     */
+    void clearDirtyFlags();
+
+private:
+
+    /**
+     * Returns a new entity of given kind, with a unique id
+     */
+    SimEntity* createEntity(EntityKind kind);
+
+    void addEvent(const SimEvent& event);
+
+    /**
+     * Called by tick()
+     * Run a phase of tick, and record its time in profiler_ (if any)
+     */
+    inline void runPhase(const char* name, void (Simulation::*phase)()){
+        TickProfiler::Scope scope(profiler_, name);
+        (this->*phase)();
+    }
+
+    /**
+     * Called by tick()
+     * Check if monsters are to be generated in each tick.
+     * If so, do it.
+     */
+    void generateMonsters();
+
+    /**
+     * Called by tick()
+     * Update status of entities, e.g. buff, continuous damage...
+     * Only entities due in this tick (refer to TimingWheel) are visited, rather than all of them
+     */
+    void updateEntityStatus();
+
+    /**
+     * Called by updateEntityStatus(), on worker threads
+     * Update status of an entity due in this tick
+     * It must only change `entity`, so that entities can be updated in parallel
+     */
+    void updateStatus(SimEntity* entity) const;
+
+    /**
+     * Called by updateStatus().
+     * Remove buffs expiring by status_time_
+     */
+    void manageBuff(SimEntity* entity) const;
+
+    /**
+     * Called by updateStatus().
+     * Do continuous extra damage, if 1000(ms) has passed since entity->continuous_damage_time
+     * Damage is determined by buffs, from which a damage rate can be calculated.
+     */
+    void doContinuousExtraDamage(SimEntity* entity) const;
+
+    /**
+     * Returns damage done per second by buffs in `buff_mask`, e.g. corrosion
+     */
+    static int continuousDamageRate(quint32 buff_mask);
+
+    /**
+     * Put entity into status_wheel_, at the first time its status changes by itself
+     * i.e. a buff expires, or continuous damage is done
+     * It's never made due later than it is now, since being due too early only costs a visit.
+     */
+    void scheduleStatus(SimEntity* entity);
+
+    /**
+     * Called when buffs of entity are added or removed out of updateEntityStatus(), e.g. by an attack
+     * Continuous damage starts being counted if it has just been caused,
+     * and recharge rate and status_wheel_ are updated.
+     * @param old_mask mask of buffs before the change
+     */
+    void buffsChanged(SimEntity* entity, quint32 old_mask);
+
+    /**
+     * Returns time (ms) the entity recharges per tick, which depends on its buffs
+     */
+    int rechargeRate(const SimEntity* entity) const;
+
+    /**
+     * Bring entity->recharged up to date, i.e. add recharge of ticks from entity->recharged_tick to `tick`
+     * It must only change `entity`, so it can be called on worker threads
+     */
+    void updateRecharged(SimEntity* entity, qint64 tick) const;
+
+    /**
+     * Called when something that recharge rate depends on changes, e.g. a buff is added
+     * Recharge until last tick is kept, and new rate is used from next tick
+     */
+    void updateRechargeRate(SimEntity* entity);
+
+    /**
+     * Put entity into character_attacks_ or monster_attacks_, at the first tick it's ready to attack
+     * If it's frozen, it's due when Buff::FROZEN expires, for rate of recharge goes up then
+     * Rate going down (e.g. Buff::WOLF_S_GRAVESTONE expires) only makes it due too early,
+     * in which case it's rescheduled in entityInteract()
+     */
+    void scheduleAttack(SimEntity* entity);
+
+    /**
+     * Try to make a flash when blocked (this condition is met by default, you should check it in moveMonster())
+     * @returns false if not having Buff::EVER_CHANGING or not recharged, true otherwise
+     */
+    bool tryFlash(SimEntity* monster) const;
+
+    /**
+     * Called by tick()
+     * Move monsters in each tick, in parallel
+     * monster_grid_ is updated after all of them are moved
+     */
+    void moveMonsters();
+
+    /**
+     * Called by moveMonsters(), on worker threads
+     * Move a monster along road for one tick
+     * It must only change `monster` (e.g. not monster_grid_), so that monsters can be moved in parallel
+     */
+    void moveMonster(SimEntity* monster) const;
+
+    /**
+     * Returns if any character blocks the way of monster
+     * Only areas overlapped by the monster (4 at most) are checked
+     */
+    bool isBlocked(const SimEntity* monster) const;
+
+    /**
+     * Called by tick()
+     * Check monsters and characters, handle interactions between them
+     * e.g. An Elf attacks a Boar, a Boar attacks a Knight
+     * Only entities due in this tick (refer to AttackSchedule) are visited, rather than all of them
+     */
+    void entityInteract();
+
+    /**
+     * Called by entityInteract()
+     * Make attacks of entities due in `schedule` on entities in `targets`, in two stages:
+     * 1. each attacker selects its target in parallel, into selected_targets_
+     * 2. attacks are resolved (damage, buffs, reactions...) one by one, in order of the schedule
+     * Attacks of one side never change entities of the same side, so attackers are not changed in stage 1.
+     * If a target selected is killed by an attack resolved before, a new one is selected,
+     * so results are the same as selecting and attacking one by one.
+     * Note: ActionAttack is created in stage 2, since it takes random numbers, which must be in order.
+     */
+    void resolveAttacks(AttackSchedule& schedule, const SpatialGrid& targets);
+
+    /**
+     * Returns attack range (px) of attacker
+     */
+    qreal attackRadius(const SimEntity* attacker) const;
+
+    /**
+     * Returns the entity in `targets` to be attacked by attacker, nullptr if not ready or there is none
+     * Default implementation is to select the nearest one alive
+     * It only reads entities, so it can be called on worker threads
+     */
+    SimEntity* selectTarget(const SimEntity* attacker, const SpatialGrid& targets) const;
+
+    void attack(SimEntity* attacker, ActionAttack& action, const SpatialGrid& candidate_targets);
+
+    /**
+     * Receive an attack
+     * If attack is AOE, entities in `candidate_targets` near target are attacked as well, and so on
+     * AOE is spread in order of transmits from target, each entity is hit once at most,
+     * and max_aoe_targets_ entities at most are hit, so an attack into a dense pack costs little.
+     * Buffers are kept in members and hits are marked on entities, so no allocation is made per hit.
+     */
+    void attacked(SimEntity* target, ActionAttack& action, const SpatialGrid& candidate_targets);
+
+    /**
+     * Called by attacked()
+     * Apply damage, element reaction, buff... of an attack to its acceptor, AOE not included
+     */
+    void receiveAttack(ActionAttack& action);
+
+    /**
+     * Remove dead entities, including characters and monsters
+     */
+    void removeDeadEntity();
+
+    /**
+     * Called by tick()
+     * Check if any monster has reached the Protection Objective.
+     * If so, remove it from the field and minus health_points_ by 1.
+     */
+    void checkReachProtectionObjective();
+
+    /**
+     * Called by tick()
+     * Check if game is end
+     * Win: There no monster in field and monster_que_
+     * Lose: Otherwise, and health_points_ <= 0
+     */
+    void checkGameEnd();
+
+    /**
+     * Return if pos1 equals to pos2
+     * Taking double precision into account
+     */
+    static inline bool pointFloatEqual(const QPointF& p1, const QPointF& p2){
+        return qAbs(p1.x() - p2.x()) <= SimField::REAL_COMPENSATION
+            && qAbs(p1.y() - p2.y()) <= SimField::REAL_COMPENSATION;
+    }
+
+};
+
+#endif //AP_PROJ_SIMULATION_H
@@ -0,0 +1,100 @@
+#ifndef AP_PROJ_SPATIALGRID_H
+#define AP_PROJ_SPATIALGRID_H
+
+#include <QList>
+#include <QPointF>
+#include <QtGlobal>
+#include "SimEntity.h"
+
+/**
+ * Uniform grid bucketing entities by their pos, with one cell per area of field
+ * Used to find entities near a point without scanning all of them,
+ * e.g. targets in attack range, or targets of AOE
+ * Note:
+ * * Entity must be moved (by move()) after its pos changes, otherwise it may be missed by queries;
+ * * Cell of an entity is stored in SimEntity::grid_cell, so an entity can be in one grid at most;
+ * * Pos out of field is clamped to the nearest cell, so every entity can be inserted.
+ */
+class SpatialGrid{
+
+    qreal cell_size_ = 0; // px
+
+    int num_rows_ = 0;
+    int num_cols_ = 0;
+
+    // Cells in row-major order, each holding entities whose pos (top-left corner) is in it
+    QList<QList<SimEntity*>> cells_;
+
+    int rowOf(qreal y) const;
+
+    int colOf(qreal x) const;
+
+    int cellOf(const QPointF& pos) const;
+
+public:
+
+    explicit SpatialGrid(qreal cell_size = 0);
+
+    /**
+     * Remove all entities, and resize the grid
+     */
+    void reset(int num_rows, int num_cols);
+
+    void setCellSize(qreal size);
+
+    void insert(SimEntity* entity);
+
+    /**
+     * Remove entity from the grid
+     * If entity is not in any grid, just ignore it
+     */
+    void remove(SimEntity* entity);
+
+    /**
+     * Move entity to the cell of its current pos, called after its pos changes
+     */
+    void move(SimEntity* entity);
+
+    /**
+     * Find entities whose distance (between pos) to center is less than or equal to radius
+     * They are appended to `result` in ascending order of id,
+     * i.e. the same order as they are added into Simulation
+     */
+    void queryRange(const QPointF& center, qreal radius, QList<SimEntity*>& result) const;
+
+    /**
+     * Call func(entity) for each entity whose distance (between pos) to center is less than or equal to radius
+     * Unlike queryRange(), nothing is collected or sorted, so it never allocates,
+     * but entities are visited in no particular order.
+     * It only reads the grid, so it can be called on worker threads.
+     */
+    template<class Func>
+    void forEachInRange(const QPointF& center, qreal radius, const Func& func) const{
+        if(cells_.empty())
+            return;
+        qreal radius_squared = radius * radius;
+        int row_begin = rowOf(center.y() - radius), row_end = rowOf(center.y() + radius);
+        int col_begin = colOf(center.x() - radius), col_end = colOf(center.x() + radius);
+        for(int row = row_begin; row <= row_end; ++row){
+            for(int col = col_begin; col <= col_end; ++col){
+                for(auto* entity: cells_[row * num_cols_ + col]){
+                    if(distanceSquared(center, entity->pos) <= radius_squared)
+                        func(entity);
+                }
+            }
+        }
+    }
+
+    /**
+     * Returns square of distance between p1 and p2
+     * Compare it with square of range, to avoid qSqrt()
+     */
+    static inline qreal distanceSquared(const QPointF& p1, const QPointF& p2){
+        qreal dx = p1.x() - p2.x();
+        qreal dy = p1.y() - p2.y();
+        return dx * dx + dy * dy;
+    }
+
+};
+
+#endif //AP_PROJ_SPATIALGRID_H
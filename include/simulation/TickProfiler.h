@@ -0,0 +1,132 @@
+#ifndef AP_PROJ_TICKPROFILER_H
+#define AP_PROJ_TICKPROFILER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * Records how long each phase of a frame takes, e.g. moveMonsters() in a tick, or painting the scene
+ * Samples are kept in a ring buffer of fixed capacity, so only the latest ones are kept,
+ * and recording never allocates or locks.
+ * They can be exported as Chrome trace_event JSON, and viewed in chrome://tracing or Perfetto.
+ * Note:
+ * * Samples should be recorded by one thread only (the GUI thread for now);
+ * * Names of samples are not copied, so they must be string literals.
+ */
+class TickProfiler{
+
+public:
+
+    static constexpr const int DEFAULT_CAPACITY = 1 << 16;
+
+    /**
+     * Returns a running total of something (e.g. heap allocations), refer to setCounter()
+     */
+    using Counter = qint64 (*)();
+
+    struct Sample{
+        const char* name = nullptr;
+        qint64 start = 0; // ns since the profiler was created
+        qint64 duration = 0; // ns
+        qint64 count = 0; // Increase of counter during the sample, 0 if there is no counter
+    };
+
+    /**
+     * Record time from construction to destruction as a sample named `name`
+     * Nothing is recorded if profiler is null or not enabled (when the scope begins)
+     */
+    class Scope{
+
+        TickProfiler* profiler_;
+        const char* name_;
+        qint64 start_ = 0;
+        qint64 start_count_ = 0;
+
+    public:
+
+        Scope(TickProfiler* profiler, const char* name);
+
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+
+    };
+
+private:
+
+    QElapsedTimer clock_;
+
+    QList<Sample> ring_; // Size is a power of 2
+    quint64 mask_;
+
+    // Total number of samples recorded, the next one goes to ring_[head_ & mask_]
+    std::atomic<quint64> head_ = 0;
+
+    std::atomic<bool> enabled_ = false;
+
+    Counter counter_ = nullptr;
+
+public:
+
+    /**
+     * @param capacity max number of samples kept, rounded up to a power of 2
+     */
+    explicit TickProfiler(int capacity = DEFAULT_CAPACITY);
+
+    TickProfiler(const TickProfiler&) = delete;
+
+    TickProfiler& operator=(const TickProfiler&) = delete;
+
+    bool isEnabled() const;
+
+    /**
+     * Start or stop recording
+     * Samples recorded before are cleared when recording starts
+     */
+    void setEnabled(bool enabled);
+
+    int capacity() const;
+
+    /**
+     * Returns time (ns) since the profiler was created
+     */
+    qint64 now() const;
+
+    /**
+     * Set counter read by Scope at its beginning and end, nullptr for none
+     * e.g. ap_bench counts heap allocations of each phase by it
+     * Should be set before recording, and the counter must be safe to call from the recording thread.
+     */
+    void setCounter(Counter counter);
+
+    /**
+     * Returns value of counter, 0 if there is none
+     */
+    qint64 count() const;
+
+    /**
+     * Add a sample, the oldest one is overwritten if buffer is full
+     * Nothing happens if not enabled
+     */
+    void record(const char* name, qint64 start, qint64 duration, qint64 count = 0);
+
+    /**
+     * Returns samples kept, oldest first
+     */
+    QList<Sample> samples() const;
+
+    void clear();
+
+    /**
+     * Returns samples kept as Chrome trace_event JSON (complete events, time in μs)
+     */
+    QByteArray toChromeTrace() const;
+
+};
+
+#endif //AP_PROJ_TICKPROFILER_H
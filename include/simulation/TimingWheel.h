@@ -0,0 +1,87 @@
+#ifndef AP_PROJ_TIMINGWHEEL_H
+#define AP_PROJ_TIMINGWHEEL_H
+
+#include <QList>
+#include <QtGlobal>
+#include "SimEntity.h"
+
+/**
+ * Hierarchical timing wheel of entities by time (ms) their status is due to change, refer to Simulation::scheduleStatus()
+ * e.g. a buff expires, or continuous damage is done
+ * Used to visit only entities due in a tick, so an entity with long buffs costs nothing until they expire.
+ * Each level has NUM_SLOTS slots, and a slot of level L covers NUM_SLOTS^L ms.
+ * Entities in a slot of higher level are moved down (cascaded) when time reaches the slot,
+ * so scheduling and removing are O(1), and advancing costs O(1) per ms passed plus entities due.
+ * Note:
+ * * Position of an entity is stored in SimEntity::wheel_slot and SimEntity::wheel_pos,
+ *   so an entity can be in one wheel at most;
+ * * Entities due in the same advance() are given in no particular order.
+ */
+class TimingWheel{
+
+    static constexpr const int SLOT_BITS = 6;
+    static constexpr const int NUM_SLOTS = 1 << SLOT_BITS;
+    // Covers 2^36 ms from now, which is more than any duration (int) of buffs
+    static constexpr const int NUM_LEVELS = 6;
+
+    qint64 now_ = 0; // Time (ms) of last advance()
+
+    QList<SimEntity*> slots_[NUM_LEVELS * NUM_SLOTS];
+
+    // Bit i of occupied_[level] is set if slot i of the level is not empty
+    quint64 occupied_[NUM_LEVELS] = {};
+
+    qsizetype size_ = 0;
+
+    // Buffer of cascade(), swapped with the slot cascaded, so capacity of slots is reused rather than freed
+    QList<SimEntity*> cascading_;
+
+    void insert(SimEntity* entity);
+
+    /**
+     * Move entities in slot of `level` down to lower levels, called when time reaches the slot
+     */
+    void cascade(int level, int slot);
+
+    static inline int slotOf(qint64 time, int level){
+        return static_cast<int>((time >> (SLOT_BITS * level)) & (NUM_SLOTS - 1));
+    }
+
+public:
+
+    /**
+     * Returns time (ms) of last advance()
+     */
+    qint64 now() const;
+
+    /**
+     * Make entity due at `time` (ms), whether it's in the wheel or not
+     * If `time` <= now(), it's due in next advance(), and SimEntity::wheel_time is set to now() + 1
+     */
+    void schedule(SimEntity* entity, qint64 time);
+
+    /**
+     * Remove entity from the wheel
+     * If entity is not in the wheel, just ignore it
+     */
+    void remove(SimEntity* entity);
+
+    /**
+     * Returns if entity is in the wheel, and its due time is in SimEntity::wheel_time then
+     */
+    static bool contains(const SimEntity* entity);
+
+    /**
+     * Move time on to `time` (ms), and take all entities due at or before it out of the wheel into `due`
+     * `time` should not be less than now()
+     * Every entity is checked to be taken at the ms it's due, and an exception is thrown otherwise.
+     */
+    void advance(qint64 time, QList<SimEntity*>& due);
+
+    void clear();
+
+    qsizetype size() const;
+
+};
+
+#endif //AP_PROJ_TIMINGWHEEL_H
@@ -18,14 +18,6 @@ void Area::mouseReleaseEvent(QGraphicsSceneMouseEvent *event) {
     QGraphicsPixmapItem::mouseReleaseEvent(event);
 }
 
-bool Area::isOccupied() const {
-    return occupied_;
-}
-
-void Area::setOccupied(bool occupied) {
-    occupied_ = occupied;
-}
-
 int Area::type() const {
     return Type;
 }
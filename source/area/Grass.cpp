@@ -1,11 +1,12 @@
 #include "Grass.h"
+#include "TextureCache.h"
 
 
 Grass::Grass(QGraphicsItem *parent) : Area(parent) {
     int sz = static_cast<int>(AreaSize);
     if(sz <= 0)
         throw std::invalid_argument("Area Size not initialized");
-    setPixmap(QPixmap(TEXTURE).scaled(sz, sz));
+    setPixmap(TextureCache::get(TEXTURE, sz));
 }
 
 int Grass::type() const {
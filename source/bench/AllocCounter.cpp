@@ -0,0 +1,62 @@
+#include "AllocCounter.h"
+#include <cstdlib>
+#include <new>
+
+std::atomic<qint64> AllocCounter::count_ = 0;
+
+qint64 AllocCounter::count() {
+    return count_.load(std::memory_order_relaxed);
+}
+
+void AllocCounter::add() {
+    count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+
+// Qt containers allocate by malloc() rather than operator new, so malloc() itself is replaced,
+// forwarding to the implementation of glibc. operator new calls malloc(), so it's counted as well.
+extern "C" {
+
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t num, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(std::size_t size) {
+    AllocCounter::add();
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t num, std::size_t size) {
+    AllocCounter::add();
+    return __libc_calloc(num, size);
+}
+
+// A block growing (e.g. QList appending beyond capacity) is counted as an allocation too
+void* realloc(void* ptr, std::size_t size) {
+    AllocCounter::add();
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+
+}
+
+#else
+
+// Only operator new is counted on other platforms, so allocations of Qt containers are missed
+void* operator new(std::size_t size) {
+    AllocCounter::add();
+    if(void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include "LevelGenerator.h"
+#include <stdexcept>
+
+QList<LevelGenerator::AreaIndex> LevelGenerator::roadPath(int num_rows, int num_cols) {
+    if(num_rows < 1 || num_cols < 2)
+        throw std::invalid_argument("Field is too small to have a road");
+
+    QList<AreaIndex> path;
+    // Road runs along rows 0, 2, 4..., and goes down through the last area of odd rows
+    int last_road_row = (num_rows - 1) / 2 * 2;
+    for(int row_idx = 0; row_idx <= last_road_row; row_idx += 2){
+        bool to_right = row_idx / 2 % 2 == 0;
+        for(int k = 0; k < num_cols; ++k)
+            path.push_back(AreaIndex(row_idx, to_right ? k : num_cols - 1 - k));
+        if(row_idx != last_road_row)
+            path.push_back(AreaIndex(row_idx + 1, to_right ? num_cols - 1 : 0));
+    }
+    return path;
+}
+
+SimField LevelGenerator::zigZagField(int num_rows, int num_cols) {
+    SimField field;
+    field.reset(num_rows, num_cols);
+
+    auto path = roadPath(num_rows, num_cols);
+    // Direction is {delta of col_idx, delta of row_idx}, refer to SimArea
+    auto direction_to = [&path](int i){
+        return qMakePair(path[i + 1].y() - path[i].y(), path[i + 1].x() - path[i].x());
+    };
+    for(int i = 0; i < path.size(); ++i){
+        auto& road = field.area(path[i]);
+        road.type = SimArea::Type::ROAD;
+        // "to direction" of the last one is {0, 0} by default, i.e. monsters stop there
+        if(i + 1 == path.size())
+            break;
+        // Monsters in start area move towards the first "to direction" found
+        auto from = i == 0 ? direction_to(i) : direction_to(i - 1);
+        road.setDirection(from, direction_to(i));
+    }
+    field.addStartArea(path.front());
+    field.addProtectArea(path.back());
+    return field;
+}
+
+void LevelGenerator::generate(Simulation& simulation, const Options& options) {
+    if(options.num_monsters < 0 || options.spawn_duration < 0
+       || options.elf_spacing < 0 || options.knight_spacing < 0)
+        throw std::invalid_argument("Invalid options of level generator");
+
+    simulation.setField(zigZagField(options.num_rows, options.num_cols));
+    simulation.setHealthPoints(options.num_monsters + 1);
+
+    // Buffs are cycled among monsters
+    // Buff::FROZEN is not here, since it would stop a monster for the whole game
+    static const QList<QList<Buff>> MonsterBuffs = {
+            {},
+            {Buff::WINDFALL},
+            {Buff::WOLF_S_GRAVESTONE},
+            {Buff::EVER_CHANGING},
+            {Buff::WINDFALL, Buff::EVER_CHANGING},
+    };
+    for(int i = 0; i < options.num_monsters; ++i){
+        int arrival_time = static_cast<int>(static_cast<qint64>(options.spawn_duration) * i / qMax(options.num_monsters, 1));
+        simulation.addMonsterArrival(EntityKind::BOAR, arrival_time, MonsterBuffs[i % MonsterBuffs.size()]);
+    }
+
+    // Elves are on grass, i.e. areas in odd rows except those the road goes through
+    if(options.elf_spacing > 0){
+        int num_grass = 0;
+        for(int row_idx = 1; row_idx < options.num_rows; row_idx += 2){
+            for(int col_idx = 0; col_idx < options.num_cols; ++col_idx){
+                AreaIndex idx(row_idx, col_idx);
+                if(simulation.field().area(idx).type != SimArea::Type::GRASS)
+                    continue;
+                if(num_grass++ % options.elf_spacing == 0)
+                    simulation.placeCharacter(EntityKind::ELF, idx);
+            }
+        }
+    }
+
+    // Knights block the road, start area and Protection Objective are kept free
+    if(options.knight_spacing > 0){
+        auto path = roadPath(options.num_rows, options.num_cols);
+        for(int i = options.knight_spacing; i + 1 < path.size(); i += options.knight_spacing)
+            simulation.placeCharacter(EntityKind::KNIGHT, path[i]);
+    }
+}
@@ -0,0 +1,159 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QList>
+#include <QMap>
+#include <array>
+#include "AllocCounter.h"
+#include "LevelGenerator.h"
+#include "ParallelUtil.h"
+#include "Simulation.h"
+#include "TickProfiler.h"
+
+/**
+ * Benchmark of simulation core, which runs synthetic levels headlessly
+ * By default, a set of levels from small to huge are run,
+ * or pass --rows, --cols and --monsters to run a single one.
+ * For each level, time of ticks is reported as ns per tick and ns per entity (alive in that tick),
+ * followed by ns per tick and heap allocations per tick of each phase of tick,
+ * and allocations per hit (attack received, AOE included) of entityInteract.
+ * No display is needed, it runs under QT_QPA_PLATFORM=offscreen as well.
+ */
+
+namespace {
+
+constexpr qreal AREA_SIZE = 48; // px, same as GameField
+constexpr int TICK_INTERVAL = 16; // ms, same as GameField
+
+struct BenchResult{
+    int num_characters = 0;
+    int num_ticks = 0;
+    qint64 setup_ns = 0;
+    qint64 tick_ns = 0;
+    qint64 entity_ticks = 0; // Sum of entities on field after each tick
+    int max_entities = 0;
+    QMap<QString, qint64> phase_ns; // Total time of each phase
+    QMap<QString, qint64> phase_allocs; // Total heap allocations of each phase, refer to AllocCounter
+    qint64 num_hits = 0;
+};
+
+BenchResult runLevel(const LevelGenerator::Options& options, int num_ticks, int num_warmup_ticks){
+    BenchResult result;
+    QElapsedTimer timer;
+
+    timer.start();
+    Simulation simulation(AREA_SIZE, TICK_INTERVAL);
+    LevelGenerator::generate(simulation, options);
+    result.setup_ns = timer.nsecsElapsed();
+    result.num_characters = static_cast<int>(simulation.characters().size());
+
+    // Buffers of simulation grow to their working size in warm-up ticks, which are not measured
+    for(int i = 0; i < num_warmup_ticks && simulation.getState() == Simulation::State::RUNNING; ++i)
+        simulation.tick();
+    qint64 first_hit_count = simulation.getHitCount();
+
+    // A tick records 7 samples (itself and its phases), so that none of them is overwritten
+    TickProfiler profiler(qMax(num_ticks, 1) * 8);
+    profiler.setCounter(&AllocCounter::count);
+    profiler.setEnabled(true);
+    simulation.setProfiler(&profiler);
+
+    for(int i = 0; i < num_ticks && simulation.getState() == Simulation::State::RUNNING; ++i){
+        timer.restart();
+        simulation.tick();
+        result.tick_ns += timer.nsecsElapsed();
+        ++result.num_ticks;
+        int num_entities = static_cast<int>(simulation.monsters().size() + simulation.characters().size());
+        result.entity_ticks += num_entities;
+        result.max_entities = qMax(result.max_entities, num_entities);
+    }
+    result.num_hits = simulation.getHitCount() - first_hit_count;
+    for(const auto& sample: profiler.samples()){
+        if(qstrcmp(sample.name, "tick") != 0){
+            result.phase_ns[QString::fromLatin1(sample.name)] += sample.duration;
+            result.phase_allocs[QString::fromLatin1(sample.name)] += sample.count;
+        }
+    }
+    return result;
+}
+
+}
+
+int main(int argc, char *argv[]) try{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ap_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark of simulation core on synthetic levels");
+    parser.addHelpOption();
+    QCommandLineOption rows_option("rows", "Number of rows of field.", "n");
+    QCommandLineOption cols_option("cols", "Number of columns of field.", "n");
+    QCommandLineOption monsters_option("monsters", "Number of Boars.", "n");
+    QCommandLineOption ticks_option("ticks", "Number of ticks to run for each level.", "n", "1000");
+    QCommandLineOption warmup_option("warmup", "Number of ticks to run before measuring, for each level.", "n", "0");
+    QCommandLineOption spawn_option("spawn-duration", "Time (ms) in which all monsters arrive.", "ms", "10000");
+    QCommandLineOption elf_option("elf-spacing", "Place an Elf on every n grass areas beside road, 0 for none.", "n", "3");
+    QCommandLineOption knight_option("knight-spacing", "Place a Knight on every n road areas, 0 for none.", "n", "0");
+    QCommandLineOption threads_option("threads", "Max number of threads used by simulation, 1 to run serially.",
+                                      "n", QString::number(ParallelUtil::maxThreads()));
+    parser.addOptions({rows_option, cols_option, monsters_option, ticks_option, warmup_option,
+                       spawn_option, elf_option, knight_option, threads_option});
+    parser.process(app);
+    ParallelUtil::setMaxThreads(parser.value(threads_option).toInt());
+
+    LevelGenerator::Options base;
+    base.spawn_duration = parser.value(spawn_option).toInt();
+    base.elf_spacing = parser.value(elf_option).toInt();
+    base.knight_spacing = parser.value(knight_option).toInt();
+    int num_ticks = parser.value(ticks_option).toInt();
+    int num_warmup_ticks = parser.value(warmup_option).toInt();
+
+    // {rows, cols, monsters}
+    QList<std::array<int, 3>> levels = {
+            {12, 20, 10},
+            {50, 50, 1000},
+            {200, 200, 10000},
+            {500, 500, 100000},
+    };
+    if(parser.isSet(rows_option) || parser.isSet(cols_option) || parser.isSet(monsters_option)){
+        levels = {{
+            parser.value(rows_option).isEmpty() ? base.num_rows : parser.value(rows_option).toInt(),
+            parser.value(cols_option).isEmpty() ? base.num_cols : parser.value(cols_option).toInt(),
+            parser.value(monsters_option).isEmpty() ? base.num_monsters : parser.value(monsters_option).toInt(),
+        }};
+    }
+
+    QTextStream out(stdout);
+    out << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+            .arg("field", 9).arg("monsters", 9).arg("chars", 7).arg("ticks", 6)
+            .arg("max_ent", 8).arg("setup_ms", 9).arg("ns/tick", 12).arg("ns/entity", 10);
+    for(const auto& level: levels){
+        auto options = base;
+        options.num_rows = level[0];
+        options.num_cols = level[1];
+        options.num_monsters = level[2];
+        auto result = runLevel(options, num_ticks, num_warmup_ticks);
+        qint64 ns_per_tick = result.num_ticks ? result.tick_ns / result.num_ticks : 0;
+        qint64 ns_per_entity = result.entity_ticks ? result.tick_ns / result.entity_ticks : 0;
+        out << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                .arg(QString("%1x%2").arg(options.num_rows).arg(options.num_cols), 9)
+                .arg(options.num_monsters, 9).arg(result.num_characters, 7).arg(result.num_ticks, 6)
+                .arg(result.max_entities, 8).arg(result.setup_ns / 1000000, 9)
+                .arg(ns_per_tick, 12).arg(ns_per_entity, 10);
+        for(auto it = result.phase_ns.cbegin(); it != result.phase_ns.cend(); ++it){
+            qint64 allocs = result.phase_allocs.value(it.key());
+            out << QString("    %1 %2 ns/tick %3 allocs/tick\n").arg(it.key(), -30)
+                    .arg(result.num_ticks ? it.value() / result.num_ticks : 0, 12)
+                    .arg(result.num_ticks ? static_cast<double>(allocs) / result.num_ticks : 0.0, 10, 'f', 2);
+        }
+        qint64 hit_allocs = result.phase_allocs.value("entityInteract");
+        out << QString("    %1 %2 hits %3 allocs/hit\n").arg("entityInteract", -30).arg(result.num_hits, 12)
+                .arg(result.num_hits ? static_cast<double>(hit_allocs) / result.num_hits : 0.0, 10, 'f', 4);
+        out.flush();
+    }
+    return 0;
+}
+catch (std::exception& e){
+    qFatal("Error %s", e.what());
+}
@@ -1,21 +1,21 @@
 #include "Action.h"
 
-Action::Action(Entity *initiator, Entity *acceptor): initiator_(initiator), acceptor_(acceptor) {
+Action::Action(SimEntity *initiator, SimEntity *acceptor): initiator_(initiator), acceptor_(acceptor) {
 
 }
 
-Entity *Action::getInitiator() const {
+SimEntity *Action::getInitiator() const {
     return initiator_;
 }
 
-void Action::setInitiator(Entity *initiator) {
+void Action::setInitiator(SimEntity *initiator) {
     initiator_ = initiator;
 }
 
-Entity *Action::getAcceptor() const {
+SimEntity *Action::getAcceptor() const {
     return acceptor_;
 }
 
-void Action::setAcceptor(Entity *acceptor) {
+void Action::setAcceptor(SimEntity *acceptor) {
     acceptor_ = acceptor;
 }
@@ -36,15 +36,10 @@ void ActionAttack::setTransmitCnt(int cnt) {
     transmit_cnt_ = cnt;
 }
 
-void ActionAttack::setTextEffect(const QString &text, QColor color) {
-    text_effect_ = qMakePair(text, color);
-    has_effect_ = true;
+Reaction ActionAttack::getReaction() const {
+    return reaction_;
 }
 
-bool ActionAttack::hasTextEffect() const {
-    return has_effect_;
-}
-
-const QPair<QString, QColor> &ActionAttack::getTextEffect() const {
-    return this->text_effect_;
+void ActionAttack::setReaction(Reaction reaction) {
+    reaction_ = reaction;
 }
@@ -0,0 +1,48 @@
+#include "BuffSet.h"
+#include <limits>
+#include <stdexcept>
+
+int BuffSet::size(quint32 mask) const {
+    return qPopulationCount(mask_ & mask);
+}
+
+qint64 BuffSet::expireTime(Buff buff) const {
+    if(!contains(buff))
+        return 0;
+    return expire_times_[BuffUtil::buffToOrdinal(buff)];
+}
+
+qint64 BuffSet::nextExpireTime() const {
+    qint64 time = std::numeric_limits<qint64>::max();
+    for(quint32 rest = mask_; rest; rest &= rest - 1)
+        time = qMin(time, expire_times_[qCountTrailingZeroBits(rest)]);
+    return time;
+}
+
+void BuffSet::set(Buff buff, qint64 expire_time) {
+    int ordinal = BuffUtil::buffToOrdinal(buff);
+    if(ordinal < 0)
+        throw std::invalid_argument("Invalid buff");
+    mask_ |= 1u << ordinal;
+    expire_times_[ordinal] = expire_time;
+}
+
+void BuffSet::remove(Buff buff) {
+    mask_ &= ~BuffUtil::buffToMask(buff);
+}
+
+void BuffSet::expire(qint64 time) {
+    for(quint32 rest = mask_; rest; rest &= rest - 1){
+        int ordinal = qCountTrailingZeroBits(rest);
+        // time up for this buff
+        if(expire_times_[ordinal] <= time)
+            mask_ &= ~(1u << ordinal);
+    }
+}
+
+Buff BuffSet::first(quint32 mask) const {
+    quint32 masked = mask_ & mask;
+    if(masked == 0)
+        return Buff::NONE;
+    return BuffUtil::ordinalToBuff(qCountTrailingZeroBits(masked));
+}
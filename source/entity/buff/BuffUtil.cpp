@@ -58,6 +58,20 @@ Buff BuffUtil::stringToBuff(const QString& str){
         return Buff::WINDFALL;
     else if(upper_str == "EVER_CHANGING")
         return Buff::EVER_CHANGING;
+    else if(upper_str == "WOLF_S_GRAVESTONE")
+        return Buff::WOLF_S_GRAVESTONE;
+    else if(upper_str == "CAUSE_CORROSION")
+        return Buff::CAUSE_CORROSION;
+    else if(upper_str == "INFUSION_PYRO")
+        return Buff::INFUSION_PYRO;
+    else if(upper_str == "INFUSION_HYDRO")
+        return Buff::INFUSION_HYDRO;
+    else if(upper_str == "INFUSION_CRYO")
+        return Buff::INFUSION_CRYO;
+    else if(upper_str == "INFUSION_ANEMO")
+        return Buff::INFUSION_ANEMO;
+    else if(upper_str == "INFUSION_FROZEN")
+        return Buff::INFUSION_FROZEN;
     else
         throw std::invalid_argument("No matching buff for given string");
 }
@@ -85,13 +99,10 @@ QColor BuffUtil::buffToColor(Buff buff){
 }
 
 bool BuffUtil::isDeBuff(Buff buff){
-    return buff == Buff::CORRODED || buff == Buff::FROZEN;
+    return (buffToMask(buff) & DE_BUFF_MASK) != 0;
 }
 
 bool BuffUtil::isInfusionBuff(Buff buff) {
-    return buff == Buff::INFUSION_ANEMO
-        || buff == Buff::INFUSION_CRYO
-        || buff == Buff::INFUSION_HYDRO
-        || buff == Buff::INFUSION_PYRO;
+    return (buffToMask(buff) & INFUSION_MASK) != 0;
 }
 
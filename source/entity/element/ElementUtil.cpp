@@ -36,6 +36,35 @@ QString ElementUtil::elementToIcon(Element element) {
     }
 }
 
+QString ElementUtil::reactionToString(Reaction reaction) {
+    switch (reaction) {
+        case Reaction::VAPORIZE:
+            return "Vaporize";
+        case Reaction::MELT:
+            return "Melt";
+        case Reaction::FROZEN:
+            return "Frozen";
+        case Reaction::SWIRL:
+            return "Swirl";
+        default:
+            throw std::invalid_argument("No matching string for reaction");
+    }
+}
+
+QColor ElementUtil::reactionToColor(Reaction reaction) {
+    switch (reaction) {
+        case Reaction::VAPORIZE:
+        case Reaction::MELT:
+            return {246, 208, 112};
+        case Reaction::FROZEN:
+            return BuffUtil::buffToColor(Buff::FROZEN);
+        case Reaction::SWIRL:
+            return ElementToParticleColor(Element::ANEMO);
+        default:
+            throw std::invalid_argument("No matching color for reaction");
+    }
+}
+
 Element ElementUtil::infusionToElement(Buff buff) {
     switch (buff) {
         case Buff::INFUSION_ANEMO:
@@ -61,16 +90,16 @@ bool ElementUtil::makeElementReaction(Element aura, ActionAttack &action) {
             switch(action.getElement()){
                 case Element::HYDRO:{
                     action.setDamage(action.getDamage() * 2);
-                    action.setTextEffect("Vaporize", QColor(246, 208, 112));
+                    action.setReaction(Reaction::VAPORIZE);
                 } break; // Vaporize (2× DMG)
                 case Element::CRYO:{
                     action.setDamage(action.getDamage() * 3 / 2);
-                    action.setTextEffect("Melt", QColor(246, 208, 112));
+                    action.setReaction(Reaction::MELT);
                 } break; // Reverse Melt (1.5× DMG)
                 case Element::ANEMO:{
                     action.setTransmitCnt(2);
                     action.setElement(aura);
-                    action.setTextEffect("Swirl", ElementToParticleColor(Element::ANEMO));
+                    action.setReaction(Reaction::SWIRL);
                 } break; // Swirl (range damage and elemental absorption)
                 default:
                     break;
@@ -81,16 +110,16 @@ bool ElementUtil::makeElementReaction(Element aura, ActionAttack &action) {
             switch(action.getElement()){
                 case Element::PYRO:{
                     action.setDamage(action.getDamage() * 3 / 2);
-                    action.setTextEffect("Vaporize", QColor(246, 208, 112));
+                    action.setReaction(Reaction::VAPORIZE);
                 } break; // Reverse Vaporize (1.5× DMG)
                 case Element::CRYO:{
                     action.setBuff(Buff::FROZEN, static_cast<int>(0.5 * 1000));
-                    action.setTextEffect("Frozen", BuffUtil::buffToColor(Buff::FROZEN));
+                    action.setReaction(Reaction::FROZEN);
                 } break; // Frozen
                 case Element::ANEMO:{
                     action.setTransmitCnt(2);
                     action.setElement(aura);
-                    action.setTextEffect("Swirl", ElementToParticleColor(Element::ANEMO));
+                    action.setReaction(Reaction::SWIRL);
                 } break; // Swirl
                 default:
                     break;
@@ -101,16 +130,16 @@ bool ElementUtil::makeElementReaction(Element aura, ActionAttack &action) {
             switch(action.getElement()){
                 case Element::PYRO:{
                     action.setDamage(action.getDamage() * 2);
-                    action.setTextEffect("Melt", QColor(246, 208, 112));
+                    action.setReaction(Reaction::MELT);
                 } break; // Melt (2× DMG)
                 case Element::HYDRO:{
                     action.setBuff(Buff::FROZEN, static_cast<int>(0.5 * 1000));
-                    action.setTextEffect("Frozen", BuffUtil::buffToColor(Buff::FROZEN));
+                    action.setReaction(Reaction::FROZEN);
                 } break; // Frozen
                 case Element::ANEMO:{
                     action.setTransmitCnt(2);
                     action.setElement(aura);
-                    action.setTextEffect("Swirl", ElementToParticleColor(Element::ANEMO));
+                    action.setReaction(Reaction::SWIRL);
                 } break; // Swirl
                 default:
                     break;
@@ -126,3 +155,7 @@ bool ElementUtil::makeElementReaction(Element aura, ActionAttack &action) {
 bool ElementUtil::canApplyAura(Element element) {
     return element != Element::NONE && element != Element::ANEMO;
 }
+
+int ElementUtil::elementToTransmitCnt(Element element) {
+    return element == Element::ANEMO ? 2 : 1;
+}
@@ -0,0 +1,109 @@
+#include "MonsterOverlay.h"
+#include <QPen>
+#include <QtAlgorithms>
+#include "BuffUtil.h"
+#include "ElementUtil.h"
+#include "TextureCache.h"
+
+MonsterOverlay::MonsterOverlay(qreal monster_size, QGraphicsItem *parent):
+    QGraphicsItem(parent),
+    monster_size_(monster_size)
+{
+    // Buff icons are in a row above the monster, centered horizontally
+    // Aura icon is at the lower part of the monster
+    auto num_buffs = BuffUtil::monsterBuffs().size();
+    qreal buff_row_width = num_buffs * BUFF_ICON_SIZE + (num_buffs - 1) * BUFF_ICON_SPACING;
+    qreal left = qMin(0.0, qMin(monster_size_ / 2 - buff_row_width / 2, monster_size_ / 2 - AURA_ICON_SIZE / 2));
+    qreal right = qMax(monster_size_, qMax(monster_size_ / 2 + buff_row_width / 2, monster_size_ / 2 + AURA_ICON_SIZE / 2));
+    qreal top = -BUFF_ICON_SIZE - 4;
+    qreal bottom = qMax(monster_size_, monster_size_ * 2 / 3 + AURA_ICON_SIZE);
+    // Leave room for pen of health bar
+    bounding_rect_ = QRectF(left, top, right - left, bottom - top).adjusted(-1, -1, 1, 1);
+}
+
+int MonsterOverlay::type() const {
+    return Type;
+}
+
+QRectF MonsterOverlay::boundingRect() const {
+    return bounding_rect_;
+}
+
+const QList<QPixmap>& MonsterOverlay::buffIcons() {
+    static QList<QPixmap> icons = [](){
+        QList<QPixmap> ret;
+        for(auto buff: BuffUtil::monsterBuffs())
+            ret.push_back(TextureCache::get(BuffUtil::buffToIcon(buff), static_cast<int>(BUFF_ICON_SIZE)));
+        return ret;
+    }();
+    return icons;
+}
+
+QColor MonsterOverlay::getHealthBarColor(int health, int max_health) {
+    // Color of health bar
+    // color[i] is color when health is between {i * (1/max)} and {(i+1) * (1/max)}
+    static QList<QColor> HealthBarColor = {
+            QColor(255, 0, 0),
+            QColor(255, 128, 0),
+            QColor(255, 255, 0),
+            QColor(128, 255, 0),
+            QColor(0, 255, 0)
+    };
+    return HealthBarColor[health * HealthBarColor.size() / max_health];
+}
+
+void MonsterOverlay::setState(const SimEntity& state) {
+    // Only parts marked dirty are refreshed
+    if(!state.dirty)
+        return;
+
+    if(state.dirty & SimEntity::DIRTY_HEALTH){
+        health_ = state.getHealth();
+        max_health_ = state.max_health;
+    }
+    if(state.dirty & SimEntity::DIRTY_BUFFS){
+        buff_mask_ = 0;
+        for(auto buff: BuffUtil::monsterBuffs())
+            if(state.hasBuff(buff))
+                buff_mask_ |= BuffUtil::buffToMask(buff);
+    }
+    if((state.dirty & SimEntity::DIRTY_AURA) && state.element_aura != element_aura_){
+        aura_icon_ = state.element_aura == Element::NONE ?
+                QPixmap() :
+                TextureCache::get(ElementUtil::elementToIcon(state.element_aura), static_cast<int>(AURA_ICON_SIZE));
+        element_aura_ = state.element_aura;
+    }
+    update();
+}
+
+void MonsterOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    // Health bar
+    // No damage taken until now, don't show health bar
+    if(max_health_ > 0 && health_ < max_health_){
+        painter->setPen(QPen(Qt::white));
+        painter->setBrush(getHealthBarColor(health_, max_health_));
+        painter->drawRect(QRectF(0, 0, monster_size_ * health_ / max_health_, HEALTH_BAR_HEIGHT));
+    }
+
+    // Element aura
+    if(!aura_icon_.isNull())
+        painter->drawPixmap(QPointF(monster_size_ / 2 - AURA_ICON_SIZE / 2, monster_size_ * 2 / 3), aura_icon_);
+
+    // Buffs, only those the monster has are displayed, and they are centered as a row
+    if(buff_mask_ == 0)
+        return;
+    const auto& buffs = BuffUtil::monsterBuffs();
+    const auto& icons = buffIcons();
+    int num_shown = qPopulationCount(buff_mask_);
+    qreal row_width = num_shown * BUFF_ICON_SIZE + (num_shown - 1) * BUFF_ICON_SPACING;
+    qreal x = monster_size_ / 2 - row_width / 2;
+    for(qsizetype i = 0; i < buffs.size(); ++i){
+        if(!(buff_mask_ & BuffUtil::buffToMask(buffs[i])))
+            continue;
+        painter->drawPixmap(QPointF(x, -BUFF_ICON_SIZE - 4), icons[i]);
+        x += BUFF_ICON_SIZE + BUFF_ICON_SPACING;
+    }
+}
@@ -0,0 +1,282 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QSemaphore>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include "BuffUtil.h"
+#include "ParallelUtil.h"
+#include "SimCommand.h"
+#include "Simulation.h"
+
+/**
+ * Monte Carlo evaluator of a level with given placement of characters
+ * It runs many headless games with different seeds (so de-buffs are rolled differently) on all cores,
+ * and reports win rate, health points left, time to clear and monsters leaked as JSON.
+ *
+ * Placement file has one character per line, placed before game starts:
+ * "Kind row_idx col_idx [buff...]", e.g. "Elf 4 9 INFUSION_CRYO"
+ * Lines starting with "//" are ignored.
+ */
+
+namespace {
+
+constexpr qreal AREA_SIZE = 48; // px, same as GameField
+constexpr int TICK_INTERVAL = 16; // ms, same as GameField
+
+// A command of placement file, along with line it comes from, so that a bad one can be reported
+struct PlacementStep{
+    SimCommand command;
+    int line_no = 0;
+};
+
+struct GameResult{
+    Simulation::State state = Simulation::State::RUNNING;
+    int health_points = 0;
+    qint64 game_time = 0; // ms
+};
+
+QList<PlacementStep> loadPlacementFromFile(const QString& file_path){
+    QFile in_file(file_path);
+    if(!in_file.open(QIODevice::ReadOnly | QIODevice::Text))
+        throw std::runtime_error("Cannot open placement file");
+
+    QList<PlacementStep> steps;
+    int line_no = 0;
+    while(!in_file.atEnd()){
+        QString line = in_file.readLine().simplified();
+        ++line_no;
+        if(line.size() == 0 || line.startsWith("//"))
+            continue;
+        QStringList info = line.split(u' ', Qt::SkipEmptyParts);
+        bool row_ok = false, col_ok = false;
+        if(info.size() < 3)
+            throw std::invalid_argument(QString("Invalid placement at line %1").arg(line_no).toStdString());
+        SimCommand place{SimCommand::Type::PLACE_CHARACTER, QPoint(info[1].toInt(&row_ok), info[2].toInt(&col_ok))};
+        if(info[0] == "Elf")
+            place.kind = EntityKind::ELF;
+        else if(info[0] == "Knight")
+            place.kind = EntityKind::KNIGHT;
+        else
+            throw std::invalid_argument(QString("Invalid character at line %1").arg(line_no).toStdString());
+        if(!row_ok || !col_ok)
+            throw std::invalid_argument(QString("Invalid area index at line %1").arg(line_no).toStdString());
+        steps.push_back({place, line_no});
+        for(int i = 3; i < info.size(); ++i){
+            SimCommand toggle_buff{SimCommand::Type::TOGGLE_BUFF, place.area_idx};
+            try {
+                toggle_buff.buff = BuffUtil::stringToBuff(info[i]);
+            }catch(std::invalid_argument&){
+                toggle_buff.buff = Buff::NONE;
+            }
+            if(!BuffUtil::characterBuffs().contains(toggle_buff.buff))
+                throw std::invalid_argument(QString("Invalid buff \"%1\" at line %2").arg(info[i]).arg(line_no).toStdString());
+            steps.push_back({toggle_buff, line_no});
+        }
+    }
+    return steps;
+}
+
+/**
+ * Place characters and set their buffs as placement says
+ * Exception is thrown if any of them does not take effect, e.g. area is taken, or character has 2 buffs already,
+ * so that a report never describes a placement which didn't happen.
+ */
+void applyPlacement(Simulation& simulation, const QList<PlacementStep>& placement){
+    for(const auto& [command, line_no]: placement){
+        auto* character = simulation.execute(command);
+        if(!character)
+            throw std::invalid_argument(QString("Cannot place character at line %1").arg(line_no).toStdString());
+        // A buff is ignored if character cannot have more, and toggled off if it's given twice
+        if(command.type == SimCommand::Type::TOGGLE_BUFF && !character->hasBuff(command.buff))
+            throw std::invalid_argument(QString("Cannot set buff at line %1, "
+                                                "a character can have 2 buffs and 1 infusion at most").arg(line_no).toStdString());
+    }
+}
+
+/**
+ * Run a whole game on `level` (a simulation with level loaded but not started) until it ends or `max_time` (ms) of game time passed
+ */
+GameResult runGame(const Simulation& level, const QList<PlacementStep>& placement, quint32 seed, qint64 max_time){
+    Simulation simulation(AREA_SIZE, TICK_INTERVAL);
+    // Level is loaded once, and copied for each game
+    simulation.loadLevelFrom(level);
+    simulation.setSeed(seed);
+    applyPlacement(simulation, placement);
+    while(simulation.getState() == Simulation::State::RUNNING && simulation.getGameTime() < max_time)
+        simulation.tick();
+    return {simulation.getState(), simulation.getHealthPoints(), simulation.getGameTime()};
+}
+
+/**
+ * Run games with seeds seed, seed + 1... on `num_threads` threads
+ * Results are in order of seed, no matter how games are scheduled
+ */
+QList<GameResult> runGames(const Simulation& level, const QList<PlacementStep>& placement,
+                           int num_games, quint32 seed, qint64 max_time, int num_threads){
+    QList<GameResult> results(num_games);
+    std::atomic<int> next = 0;
+    std::atomic<bool> failed = false;
+    QString error;
+    auto run = [&](){
+        for(int i = next.fetch_add(1); i < num_games && !failed; i = next.fetch_add(1)){
+            try {
+                results[i] = runGame(level, placement, seed + static_cast<quint32>(i), max_time);
+            }catch(std::exception& e){
+                // Every game fails in the same way, keep the first one
+                if(!failed.exchange(true))
+                    error = e.what();
+            }
+        }
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(num_threads - 1, 1));
+    QSemaphore done;
+    int num_workers = qMin(num_threads - 1, num_games);
+    for(int i = 0; i < num_workers; ++i){
+        pool.start([&run, &done](){
+            run();
+            done.release();
+        });
+    }
+    run();
+    done.acquire(qMax(num_workers, 0));
+    if(failed)
+        throw std::runtime_error(error.toStdString());
+    return results;
+}
+
+QJsonObject distribution(const QList<qint64>& values){
+    QMap<qint64, int> counts;
+    for(auto val: values)
+        ++counts[val];
+    QJsonObject result;
+    for(auto it = counts.cbegin(); it != counts.cend(); ++it)
+        result.insert(QString::number(it.key()), it.value());
+    return result;
+}
+
+/**
+ * Returns mean, min, max and percentiles of values, null if there is none
+ */
+QJsonValue summary(QList<qint64> values){
+    if(values.empty())
+        return QJsonValue::Null;
+    std::sort(values.begin(), values.end());
+    auto percentile = [&values](int p){
+        return static_cast<double>(values[(values.size() - 1) * p / 100]);
+    };
+    double sum = 0;
+    for(auto val: values)
+        sum += static_cast<double>(val);
+    return QJsonObject{
+            {"mean", sum / static_cast<double>(values.size())},
+            {"min", static_cast<double>(values.front())},
+            {"p10", percentile(10)},
+            {"p50", percentile(50)},
+            {"p90", percentile(90)},
+            {"max", static_cast<double>(values.back())},
+    };
+}
+
+}
+
+int main(int argc, char *argv[]) try{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ap_eval");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Monte Carlo evaluator of a level with given placement of characters");
+    parser.addHelpOption();
+    parser.addPositionalArgument("level", "Directory of level, having field.dat, characters.dat, monsters.dat and level_setting.dat, or a level pack (*.aplv).");
+    parser.addPositionalArgument("placement", "Placement file, each line is \"Kind row_idx col_idx [buff...]\".");
+    QCommandLineOption games_option("games", "Number of games to run.", "n", "1000");
+    QCommandLineOption seed_option("seed", "Seed of the first game, game i uses seed + i.", "seed", "1");
+    QCommandLineOption max_time_option("max-time", "Stop a game after this much game time (ms).", "ms", "600000");
+    QCommandLineOption threads_option("threads", "Number of threads running games.", "n",
+                                      QString::number(QThread::idealThreadCount()));
+    QCommandLineOption output_option(QStringList{"o", "output"}, "Write JSON to file instead of stdout.", "file");
+    parser.addOptions({games_option, seed_option, max_time_option, threads_option, output_option});
+    parser.process(app);
+
+    if(parser.positionalArguments().size() != 2)
+        parser.showHelp(1);
+    QString level_path = parser.positionalArguments()[0];
+    QString placement_path = parser.positionalArguments()[1];
+    int num_games = parser.value(games_option).toInt();
+    quint32 seed = parser.value(seed_option).toUInt();
+    qint64 max_time = parser.value(max_time_option).toLongLong();
+    int num_threads = qMax(parser.value(threads_option).toInt(), 1);
+    if(num_games <= 0 || max_time <= 0)
+        throw std::invalid_argument("Number of games and max time should be positive");
+
+    // Games are run in parallel, so each of them runs on a single thread
+    ParallelUtil::setMaxThreads(1);
+
+    auto placement = loadPlacementFromFile(placement_path);
+    // Level is only read by games, each of which copies it
+    Simulation level(AREA_SIZE, TICK_INTERVAL);
+    level.loadLevelFromFile(level_path);
+    int initial_health_points = level.getHealthPoints();
+    auto results = runGames(level, placement, num_games, seed, max_time, num_threads);
+
+    int num_won = 0, num_lost = 0;
+    QList<qint64> health_points, leaked, time_to_clear;
+    for(const auto& result: results){
+        if(result.state == Simulation::State::WON){
+            ++num_won;
+            time_to_clear.push_back(result.game_time);
+        }
+        else if(result.state == Simulation::State::LOST)
+            ++num_lost;
+        health_points.push_back(qMax(result.health_points, 0));
+        // Each monster reaching Protection Objective takes a health point
+        leaked.push_back(initial_health_points - result.health_points);
+    }
+
+    QJsonObject report{
+            {"level", level_path},
+            {"placement", placement_path},
+            {"games", num_games},
+            {"seed", static_cast<double>(seed)},
+            {"max_time_ms", static_cast<double>(max_time)},
+            {"won", num_won},
+            {"lost", num_lost},
+            {"unfinished", num_games - num_won - num_lost},
+            {"win_rate", static_cast<double>(num_won) / num_games},
+            {"health_points", QJsonObject{
+                    {"initial", initial_health_points},
+                    {"summary", summary(health_points)},
+                    {"distribution", distribution(health_points)},
+            }},
+            {"time_to_clear_ms", summary(time_to_clear)},
+            {"leaked_monsters", QJsonObject{
+                    {"summary", summary(leaked)},
+                    {"distribution", distribution(leaked)},
+            }},
+    };
+    auto json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if(parser.isSet(output_option)){
+        QFile out_file(parser.value(output_option));
+        if(!out_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+            throw std::runtime_error("Cannot open output file");
+        out_file.write(json);
+    }
+    else{
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
+catch (std::exception& e){
+    qFatal("Error %s", e.what());
+}
@@ -3,20 +3,26 @@
 #include <QDir>
 #include <QMediaPlayer>
 #include <QAudioOutput>
+#include "TextureCache.h"
 #include <QGraphicsSimpleTextItem>
 
 
 GameField::GameField(QObject* parent):
-    QGraphicsScene(parent)
+    QGraphicsScene(parent),
+    simulation_(AREA_SIZE, TICK_INTERVAL)
 {
     // handle process events
-    timer_.setInterval(static_cast<int>(1000 /* ms */ / fps_));
+    // Timer only decides how often a frame is displayed, game speed is decided by TICK_INTERVAL
+    timer_.setTimerType(Qt::PreciseTimer);
+    timer_.setInterval(qRound(1000 /* ms */ / fps_));
     connect(&timer_, &QTimer::timeout, this, &GameField::updateField);
+    // Events are taken and displayed after each tick
+    simulation_.setRecordEvents(true);
+    // Input of player is recorded, so that the game can be saved as a replay
+    simulation_.setRecordCommands(true);
 
     // Initialize some info of Character, Area and Monster
     // including area size
-    Entity::setAreaSize(AREA_SIZE);
-    Entity::setRefreshInterval(timer_.interval());
     Character::setCharacterSize(CHARACTER_SIZE);
     Area::setAreaSize(AREA_SIZE);
     Monster::setMonsterSize(MONSTER_SIZE);
@@ -24,153 +30,18 @@ GameField::GameField(QObject* parent):
 
 
 void GameField::loadLevelFromFile(const QString& dir_path) {
-    // Check if the dir exists
-    if(!QDir(dir_path).exists())
-        throw std::runtime_error("Directory does not exist");
-    // Load field data
-    loadFieldFromFile(QString("%1/field.dat").arg(dir_path));
-    // Load characters from data
-    loadCharacterOptionFromFile(QString("%1/characters.dat").arg(dir_path));
-    // Load monsters
-    loadMonsterQueueFromFile(QString("%1/monsters.dat").arg(dir_path));
-    // Load level settings
-    loadLevelSettingFromFile(QString("%1/level_setting.dat").arg(dir_path));
+    // Load field, characters, monsters and level settings
+    simulation_.loadLevelFromFile(dir_path);
     // Some UI need to set up after initialization above
     loadStyleFromFile();
 
+    initFieldUi();
     initCharacterOptionUi();
     initBuffOptionUi();
     initStatusBarUi();
     initMedia();
 }
 
-void GameField::loadFieldFromFile(const QString &file_path) {
-    QFile in_file(file_path);
-    if(!in_file.open(QIODevice::ReadOnly | QIODevice::Text))
-        return;
-
-    QString line;
-    // read length and width
-    line = in_file.readLine().simplified();
-    QStringList size = line.split(u' ', Qt::SkipEmptyParts);
-    num_rows_ = size[0].toInt();
-    num_cols_ = size[1].toInt();
-    if(num_rows_ <= 0 || num_cols_ <= 0)
-        throw std::invalid_argument("Invalid field size");
-
-    // read indices of road areas
-    // begin with a line, with size of roads in it
-    // then comes size lines, each of them looks like this:
-    // "row_idx,col_idx,to_direction,to_direction,to_direction,to_direction,road_type"
-    // The 4 directions are values mapped from {-1, 0}, {0, 1}, {1, 0}, {0, -1}
-    // Each direction_ looks like "x,y", so it should be split by ',' as well
-    // road_type: 1 to start, 2 to Protection Objective, otherwise 0
-    // TODO: Invalid input
-    QHash<AreaIndex, Area*> pos2road;
-    while(!in_file.atEnd()){
-        line = in_file.readLine().simplified();
-        QStringList info = line.split(u' ', Qt::SkipEmptyParts);
-        Road* road = new Road();
-        int directions[5] = {-1, 0, 1, 0, -1};
-        for(int k = 0; k < 4; ++k){
-            QPair<int, int> from = qMakePair(directions[k], directions[k + 1]);
-            QPair<int, int> to = qMakePair(info[2 + k * 2].toInt(), info[3 + k * 2].toInt());
-            road->setDirection(from, to);
-        }
-        AreaIndex pos = QPoint(info[0].toInt(), info[1].toInt());
-        pos2road[pos] = road;
-        if(info[10].toInt() == 1)
-            start_areas_idx_.push_back(pos);
-        else if(info[10].toInt() == 2)
-            protect_areas_idx_.push_back(pos);
-    }
-    in_file.close();
-
-    // fill the field
-    areas_ = QList<QList<Area*>>(num_rows_);
-    for(int i = 0; i < num_rows_; ++i){
-        for(int j = 0; j < num_cols_; ++j){
-            auto pos = QPoint(i, j);
-            Area* item = pos2road.value(pos, new Grass());
-            addItem(item);
-            item->setPos(AREA_SIZE * j, AREA_SIZE * i);
-            areas_[i].push_back(item);
-        }
-    }
-}
-
-void GameField::loadCharacterOptionFromFile(const QString& file_path) {
-    // There are strings indicating characters in the file
-    // Each line represents a character, which may be "Elf", "Knight", etc.
-    // Read them out, and fill character_makers_ and character_textures_ correspondingly
-    QFile in_file(file_path);
-    if(!in_file.open(QIODevice::ReadOnly | QIODevice::Text))
-        return;
-    QString line;
-    while(!in_file.atEnd()){
-        line = in_file.readLine().trimmed();
-        std::function<Character*()> maker;
-        QString texture_file_path;
-        if(line.size() == 0 || line.startsWith("//")){
-            continue;
-        }
-        else if(line == "Elf"){
-            maker = []{return new Elf;};
-            texture_file_path = Elf::TEXTURE;
-        }
-        else if(line == "Knight"){
-            maker = []{return new Knight;};
-            texture_file_path = Knight::TEXTURE;
-        }
-        else{
-            throw std::invalid_argument("Invalid character in characters.dat");
-        }
-        character_makers_.push_back(maker);
-        character_textures_.push_back(texture_file_path);
-    }
-    in_file.close();
-}
-
-void GameField::loadMonsterQueueFromFile(const QString& file_path) {
-    // There lines in this file
-    // Each line is made up of (Monster name, arrival time(ms))
-    // e.g. one line is "Boar 30"
-    QFile in_file(file_path);
-    if(!in_file.open(QIODevice::ReadOnly | QIODevice::Text))
-        return;
-
-    QString line;
-    while(!in_file.atEnd()){
-        line = in_file.readLine().simplified();
-        if(line.size() == 0 || line.startsWith("//"))
-            continue;
-        QStringList info = line.split(u' ', Qt::SkipEmptyParts);
-        QPair<Monster*, int> monster_arrival;
-        if(info[0] == "Boar")
-            monster_arrival.first = new Boar;
-        else
-            throw std::invalid_argument("Invalid monster in monsters.dat");
-        monster_arrival.second = info[1].toInt();
-        // Add buffs
-        // By default, buff duration is 100 seconds
-        for(int i = 2; i < info.size(); ++i)
-            monster_arrival.first->addBuff(BuffUtil::stringToBuff(info[i]), 100 * 1000);
-        this->monster_que_.enqueue(monster_arrival);
-    }
-    in_file.close();
-}
-
-void GameField::loadLevelSettingFromFile(const QString& file_path) {
-    // Line 1: Life points of player
-    QFile in_file(file_path);
-    if(!in_file.open(QIODevice::ReadOnly | QIODevice::Text))
-        return;
-
-    this->health_points_ = in_file.readLine().simplified().toInt();
-
-    in_file.close();
-}
-
 void GameField::loadStyleFromFile(){
     QFile in_file(CHARACTER_OPTION_BUTTON_STYLE_FILE);
     if(in_file.open(QIODevice::ReadOnly | QIODevice::Text)){
@@ -179,20 +50,42 @@ void GameField::loadStyleFromFile(){
     }
 }
 
+void GameField::initFieldUi() {
+    const auto& field = simulation_.field();
+    areas_ = QList<QList<Area*>>(field.numRows());
+    for(int i = 0; i < field.numRows(); ++i){
+        for(int j = 0; j < field.numCols(); ++j){
+            auto idx = QPoint(i, j);
+            Area* item;
+            if(field.area(idx).type == SimArea::Type::ROAD)
+                item = new Road();
+            else
+                item = new Grass();
+            addItem(item);
+            item->setPos(field.indexToPos(idx));
+            areas_[i].push_back(item);
+        }
+    }
+
+    // Effects are displayed above monsters (z = 2), and below result of game (z = 3)
+    effects_->setRect(QRectF(0, 0, field.numCols() * AREA_SIZE, field.numRows() * AREA_SIZE));
+    effects_->setZValue(2.5);
+    addItem(effects_);
+}
+
 void GameField::initCharacterOptionUi() {
     // Construct place buttons and set as invisible
     auto* place_options_layout = new QGraphicsLinearLayout;
-    for(int i = 0; i < character_makers_.size(); ++i){
-        auto& maker = character_makers_[i];
-        auto file_name = character_textures_[i];
-        auto button_pixmap = QPixmap(file_name).scaled(CHARACTER_OPTION_SIZE, CHARACTER_OPTION_SIZE);
+    for(auto kind: simulation_.characterOptions()){
+        auto file_name = characterTexture(kind);
+        auto button_pixmap = TextureCache::get(file_name, CHARACTER_OPTION_SIZE);
         auto* button = new QPushButton();
         button->setIcon(button_pixmap);
         button->setIconSize(QSize(CHARACTER_OPTION_SIZE, CHARACTER_OPTION_SIZE));
         button->setStyleSheet(character_option_button_style_);
         connect(button, &QPushButton::released,
-                [maker = maker, this](){
-                    this->placeCharacter(maker);
+                [kind = kind, this](){
+                    this->placeCharacter(kind);
                 });
         auto* proxy = new QGraphicsProxyWidget;
         proxy->setWidget(button);
@@ -206,7 +99,7 @@ void GameField::initCharacterOptionUi() {
     auto* upgrade_options_layout = new QGraphicsLinearLayout;
     QStringList upgrade_options_icons = {ICON_UP, ICON_X};
     for(const auto& icon: upgrade_options_icons){
-        auto button_pixmap = QPixmap(icon).scaled(CHARACTER_OPTION_SIZE, CHARACTER_OPTION_SIZE);
+        auto button_pixmap = TextureCache::get(icon, CHARACTER_OPTION_SIZE);
         auto* button = new QPushButton();
         button->setIcon(button_pixmap);
         button->setIconSize(QSize(CHARACTER_OPTION_SIZE, CHARACTER_OPTION_SIZE));
@@ -233,7 +126,7 @@ void GameField::initBuffOptionUi() {
     auto* buff_options_layout = new QGraphicsLinearLayout;
     for(auto buff: BuffUtil::characterBuffs()){
         auto icon_name = BuffUtil::buffToIcon(buff);
-        auto button_pixmap = QPixmap(icon_name).scaled(BUFF_OPTION_SIZE, BUFF_OPTION_SIZE);
+        auto button_pixmap = TextureCache::get(icon_name, BUFF_OPTION_SIZE);
 
         auto* button = new QPushButton();
         button->setCheckable(true); // Checked if character has this buff
@@ -268,13 +161,13 @@ void GameField::initStatusBarUi(){
     QBrush bg_brush(QColor(184, 185, 196));
     status_background->setPen(bg_pen);
     status_background->setBrush(bg_brush);
-    status_background->setRect(0, -AREA_SIZE, AREA_SIZE * this->num_cols_, AREA_SIZE);
+    status_background->setRect(0, -AREA_SIZE, AREA_SIZE * simulation_.field().numCols(), AREA_SIZE);
     addItem(status_background);
 
     int separate_space = 6;
 
     // Add status UI
-    auto health_icon_pix = QPixmap(ICON_HEALTH).scaled(ICON_HEALTH_SIZE, ICON_HEALTH_SIZE);
+    auto health_icon_pix = TextureCache::get(ICON_HEALTH, ICON_HEALTH_SIZE);
     auto* health_icon = new QGraphicsPixmapItem(health_icon_pix, status_background);
     health_icon->setX(health_icon->boundingRect().width() / 2);
     health_icon->setY(status_background->rect().center().y() - health_icon->boundingRect().center().y());
@@ -282,17 +175,17 @@ void GameField::initStatusBarUi(){
     QFont font(tr("汉仪文黑-85W"), 20);
     health_point_counter_ = new QGraphicsSimpleTextItem(status_background);
     health_point_counter_->setFont(font);
-    health_point_counter_->setText(tr("× %1").arg(health_points_));
+    health_point_counter_->setText(tr("× %1").arg(simulation_.getHealthPoints()));
     health_point_counter_->setX(health_icon->x() + health_icon->boundingRect().width() + separate_space);
     health_point_counter_->setY(status_background->rect().center().y() - health_point_counter_->boundingRect().center().y());
 
     monster_counter_ = new QGraphicsSimpleTextItem(status_background);
     monster_counter_->setFont(font);
-    monster_counter_->setText(tr("× %1").arg(monster_que_.size()));
+    monster_counter_->setText(tr("× %1").arg(simulation_.getMonsterQueueSize()));
     monster_counter_->setX(status_background->rect().width() - monster_counter_->boundingRect().width() * 1.5);
     monster_counter_->setY(status_background->rect().center().y() - monster_counter_->boundingRect().center().y());
 
-    auto monster_icon_pix = QPixmap(ICON_MONSTER).scaled(ICON_MONSTER_SIZE, ICON_MONSTER_SIZE);
+    auto monster_icon_pix = TextureCache::get(ICON_MONSTER, ICON_MONSTER_SIZE);
     auto* monster_icon = new QGraphicsPixmapItem(monster_icon_pix, status_background);
     monster_icon->setX(monster_counter_->x() - monster_icon->boundingRect().width() - separate_space);
     monster_icon->setY(status_background->rect().center().y() - monster_icon->boundingRect().center().y());
@@ -310,12 +203,55 @@ void GameField::initMedia(){
 
 void GameField::setFps(qreal fps) {
     fps_ = fps;
-    timer_.setInterval(static_cast<int>(1000 /* ms */ / fps_));
+    timer_.setInterval(qRound(1000 /* ms */ / fps_));
+}
+
+void GameField::setSpeed(int speed) {
+    if(speed < 0)
+        throw std::invalid_argument("Invalid game speed");
+    speed_ = speed;
+    tick_accumulator_ = 0;
+}
+
+int GameField::getSpeed() const {
+    return speed_;
+}
+
+Replay GameField::replay() const {
+    Replay replay;
+    replay.seed = simulation_.getSeed();
+    replay.commands = simulation_.commands();
+    return replay;
+}
+
+void GameField::startReplay(const Replay& replay) {
+    simulation_.setSeed(replay.seed);
+    simulation_.startReplay(replay.commands);
+}
+
+void GameField::setProfiler(TickProfiler* profiler) {
+    profiler_ = profiler;
+    simulation_.setProfiler(profiler);
+}
+
+void GameField::drawBackground(QPainter *painter, const QRectF &rect) {
+    if(profiler_)
+        paint_start_ = profiler_->now();
+    QGraphicsScene::drawBackground(painter, rect);
+}
+
+void GameField::drawForeground(QPainter *painter, const QRectF &rect) {
+    QGraphicsScene::drawForeground(painter, rect);
+    if(profiler_)
+        profiler_->record("paintScene", paint_start_, profiler_->now() - paint_start_);
 }
 
 
 void GameField::mouseReleaseEvent(QGraphicsSceneMouseEvent *mouseEvent) {
     QGraphicsScene::mouseReleaseEvent(mouseEvent);
+    // Player cannot interfere with a replay
+    if(simulation_.isReplaying())
+        return;
     // If any UI is visible, or pos is out of bound of scene,
     // ignore this event and hide all option UIs
     auto pos = mouseEvent->scenePos();
@@ -330,9 +266,8 @@ void GameField::mouseReleaseEvent(QGraphicsSceneMouseEvent *mouseEvent) {
         return;
     }
 
-    auto area_idx = posToIndex(pos);
-    auto* area = areas_[area_idx.x()][area_idx.y()];
-    if(area->isOccupied()){
+    auto area_idx = simulation_.field().posToIndex(pos);
+    if(simulation_.field().area(area_idx).occupant){
         displayCharacterOptions(area_idx, upgrade_options_);
         updateBuffOptionChecked(area_idx);
     }
@@ -362,8 +297,8 @@ void GameField::displayCharacterOptions(const AreaIndex& area_idx, QGraphicsWidg
 
 void GameField::updateBuffOptionChecked(const AreaIndex& area_idx){
     auto* area = areas_[area_idx.x()][area_idx.y()];
-    // If not has Character as a child, exception will be thrown
-    Character* character = getCharacterInArea(area);
+    // If not has Character in it, exception will be thrown
+    SimEntity* character = simulation_.getCharacterInArea(area_idx);
     if(!character)
         throw std::runtime_error("area doesn't has a Character");
 
@@ -385,16 +320,62 @@ void GameField::updateBuffOptionChecked(const AreaIndex& area_idx){
 }
 
 
-typename GameField::AreaIndex GameField::posToIndex(QPointF pos) {
-    qreal x = pos.x();
-    qreal y = pos.y();
-    auto res = QPoint();
-    res.ry() = x < 0 ? -1 : qFloor(x + REAL_COMPENSATION) / qRound(AREA_SIZE);
-    res.rx() = y < 0 ? -1 : qFloor(y + REAL_COMPENSATION) / qRound(AREA_SIZE);
-    return res;
+GameField::AreaIndex GameField::areaIndex(const Area* area) const {
+    return simulation_.field().posToIndex(area->pos());
+}
+
+Entity* GameField::createEntityView(EntityKind kind) {
+    Entity* view;
+    switch (kind) {
+        case EntityKind::ELF:
+            view = new Elf;
+            break;
+        case EntityKind::KNIGHT:
+            view = new Knight;
+            break;
+        case EntityKind::BOAR:
+            view = new Boar;
+            break;
+        default:
+            throw std::invalid_argument("No graphics for entity kind");
+    }
+    view->setEntityKind(kind);
+    return view;
+}
+
+Entity* GameField::takeMonsterView(const SimEntity& state) {
+    Entity* view;
+    auto& pool = monster_view_pool_[state.kind];
+    if(!pool.empty()){
+        // All of its state is reset by syncState(), for state of a new monster is all dirty
+        view = pool.takeLast();
+        view->show();
+    }
+    else{
+        view = createEntityView(state.kind);
+        addItem(view);
+        // Set position as center of area
+        view->setOffset(QPointF(AREA_SIZE / 2, AREA_SIZE / 2) - view->boundingRect().center());
+    }
+    view->setEntityId(state.id);
+    entity_views_[state.id] = view;
+    return view;
+}
+
+QString GameField::characterTexture(EntityKind kind) {
+    switch (kind) {
+        case EntityKind::ELF:
+            return Elf::TEXTURE;
+        case EntityKind::KNIGHT:
+            return Knight::TEXTURE;
+        default:
+            throw std::invalid_argument("No texture for character kind");
+    }
 }
 
 void GameField::startGame() {
+    // Time during pause should not be caught up
+    frame_clock_.start();
     timer_.start();
 }
 
@@ -402,37 +383,15 @@ void GameField::pauseGame() {
     timer_.stop();
 }
 
-void GameField::checkReachProtectionObjective() {
-    auto it = monsters_.begin();
-    while(it != monsters_.end()){
-        Monster* monster = *it;
-        // Still heading for protection objective
-        if(monster->getDirection() != qMakePair(0, 0)) {
-            ++it;
-            continue;
-        }
-        auto cur_pos = monster->pos();
-        auto cur_area_idx = posToIndex(cur_pos);
-        if(!protect_areas_idx_.contains(cur_area_idx)){
-            throw std::runtime_error(
-                    "Game Error: monster direction is {0, 0} "
-                    "but hasn't reach protection objective"
-                    );
-        }
-        health_points_--;
-        removeItem(monster);
-        it = monsters_.erase(it);
-    }
-}
-
 void GameField::checkGameEnd() {
-    if(health_points_ > 0 && (!monsters_.empty() || !monster_que_.empty()))
+    if(simulation_.getState() == Simulation::State::RUNNING)
         return;
+    bool is_win = simulation_.getState() == Simulation::State::WON;
 
     auto* background = new QGraphicsRectItem;
     background->setPen(Qt::NoPen);
     background->setBrush(QBrush(
-            (monsters_.empty() && monster_que_.empty()) ?
+            is_win ?
             QColor(0, 0, 0, 128) : // Win
             QColor(255, 0, 0, 128) // Lose
     ));
@@ -444,7 +403,7 @@ void GameField::checkGameEnd() {
     QFont font(tr("汉仪文黑-85W"), 30);
     text_hint->setFont(font);
     text_hint->setText(
-            (monsters_.empty() && monster_que_.empty()) ?
+            is_win ?
             "Challenge Completed" : // Win
             "Game Over" // Lose
             );
@@ -457,271 +416,168 @@ void GameField::checkGameEnd() {
     timer_.stop();
 }
 
-void GameField::moveMonsters() {
-    for(auto* monster: monsters_){
-        // Check if any character blocks its way
-        // If so, stop it from moving
-        bool blocked = false;
-        for(auto* character: characters_)
-            if(monster->collidesWithItem(character)){
-                blocked = true;
-                break;
-            }
-
-        qreal total_move_dis = monster->getSpeed() * timer_.interval() / 1000;
-        // Try to flash if blocked by a character
-        // Default flash distance is 2 blocks' length
-        if(blocked) {
-            if(monster->tryFlash())
-                total_move_dis = AREA_SIZE * 2;
-            else
-                continue;
-        }
-
-        while(total_move_dis > REAL_COMPENSATION){
-            // Limit move_dis in one loop
-            // so that it is not more than one area.
-            // For security, the limit is half the size of area
-            qreal move_dis = qMin(AREA_SIZE / 2, total_move_dis);
-            total_move_dis -= move_dis;
-
-            auto cur_direction = monster->getDirection();
-            if(cur_direction == qMakePair(0, 0))
-                break;
-            auto cur_pos = monster->pos();
-            auto next_pos = cur_pos;
-            next_pos.setX(next_pos.x() + cur_direction.first * move_dis);
-            next_pos.setY(next_pos.y() + cur_direction.second * move_dis);
-
-            auto cur_area_idx = posToIndex(cur_pos);
-            auto next_area_idx = posToIndex(next_pos);
-
-            // After moving, monster is in the origin area.
-            if(cur_area_idx == next_area_idx){
-                monster->setPos(next_pos);
-                move_dis = 0.0;
-                auto cur_area = qgraphicsitem_cast<Road*>(areas_[cur_area_idx.x()][cur_area_idx.y()]);
-                // If pos is same as any area,
-                // direction may need to be changed
-                if(pointFloatEqual(monster->pos(), cur_area->pos()))
-                    monster->setDirection(cur_area->getToDirection(monster->getDirection()));
-                continue;
-            }
-
-            /* Go into another area
-             *
-             * In posToIndex(), each area has two edges,
-             * so there are 2 situations.
-             *
-             * If direction is {-1, 0} or {0, -1},
-             * new direction should come from next_area
-             *
-             * Else if direction is {1, 0} or {0, 1},
-             * new direction should come from cur_area
-             *
-             * For more details, refer to code below
-             *
-             * Note:
-             * Under normal conditions, next_area would not out of range,
-             * so just ignore the condition
-             */
-            auto cur_area = qgraphicsitem_cast<Road*>(areas_[cur_area_idx.x()][cur_area_idx.y()]);
-            if(cur_direction == qMakePair(-1, 0)
-               || cur_direction == qMakePair(0, -1)){
-                auto cur_area_pos = cur_area->pos();
-                move_dis -= qAbs(cur_area_pos.x() - cur_pos.x());
-                move_dis -= qAbs(cur_area_pos.y() - cur_pos.y());
-                // Edge condition: monster's pos is exactly the pos of area,
-                // direction has been set before, and cannot be reset.
-                if(!pointFloatEqual(monster->pos(), cur_area->pos()))
-                    monster->setDirection(cur_area->getToDirection(monster->getDirection()));
-                monster->setPos(cur_area_pos);
-
-                // Reach protection obj
-                if(protect_areas_idx_.contains(cur_area_idx)){
-                    monster->setDirection(qMakePair(0, 0));
-                    break;
-                }
-
-                // Attention: if new direction is same as th old one
-                // and monster's pos is exactly the one of some area,
-                // we need to continue moving.
-                qreal cont_move_dis = qMin(AREA_SIZE / 2, move_dis);
-                cur_direction = monster->getDirection();
-                cur_pos = monster->pos();
-                next_pos = cur_pos;
-                next_pos.setX(next_pos.x() + cur_direction.first * cont_move_dis);
-                next_pos.setY(next_pos.y() + cur_direction.second * cont_move_dis);
-                move_dis -= cont_move_dis;
-                monster->setPos(next_pos);
-            }
-            else{
-                auto next_area = qgraphicsitem_cast<Road*>(areas_[next_area_idx.x()][next_area_idx.y()]);
-                auto next_area_pos = next_area->pos();
-                move_dis -= qAbs(next_area_pos.x() - cur_pos.x());
-                move_dis -= qAbs(next_area_pos.y() - cur_pos.y());
-                monster->setPos(next_area_pos);
-                monster->setDirection(next_area->getToDirection(monster->getDirection()));
-                // Reach protection obj
-                if(protect_areas_idx_.contains(next_area_idx)){
-                    monster->setDirection(qMakePair(0, 0));
-                    break;
-                }
-            }
-            // if move_dis is greater than 0, it needs to be back to total distance
-            if(move_dis > REAL_COMPENSATION)
-                total_move_dis += move_dis;
-        }
+void GameField::syncEntityViews(qreal alpha) {
+    for(auto* monster: simulation_.monsters()){
+        auto* view = entity_views_.value(monster->id);
+        // Monster is just generated
+        if(!view)
+            view = takeMonsterView(*monster);
+        view->syncState(*monster, alpha);
+    }
+    for(auto* character: simulation_.characters()){
+        auto* view = entity_views_.value(character->id);
+        // Character is placed by a replay
+        if(!view)
+            view = createCharacterView(*character);
+        view->syncState(*character, alpha);
     }
 }
 
-
-void GameField::generateMonsters() {
-    while(!monster_que_.empty() && monster_que_.head().second <= game_time_){
-        auto monster_arrival = monster_que_.dequeue();
-        auto *monster = monster_arrival.first;
-        addItem(monster);
-        monsters_.push_back(monster);
-        // Select a start area randomly
-        auto start_idx = start_areas_idx_[QRandomGenerator::global()->bounded(start_areas_idx_.size())];
-        auto start_area = areas_[start_idx.x()][start_idx.y()];
-        auto start_pos = start_area->pos();
-        monster->setPos(start_pos);
-        // Set position as center of area
-        monster->setOffset(start_area->boundingRect().center() - monster->boundingRect().center());
-        // Init moving direction of the monster
-        int directions[5] = {-1, 0, 1, 0, -1};
-        for(int i = 0; i < 4; ++i){
-            Direction from = qMakePair(directions[i], directions[i + 1]);
-            // C++17 If statement with initializer
-            if(auto to = qgraphicsitem_cast<Road*>(start_area)->getToDirection(from); to != qMakePair(0, 0)) {
-                monster->setDirection(to);
+void GameField::handleSimEvents() {
+    // Graphics of an entity may be missing,
+    // e.g. a monster generated and killed in the same tick
+    // When fast forwarding, only effects of last tick are displayed,
+    // since there are too many of them to be seen, and too expensive to create
+    bool skip_stale_effects = speed_ != NORMAL_SPEED;
+    for(const auto& event: simulation_.takeEvents()){
+        bool is_effect = event.type == SimEvent::Type::ATTACK
+                         || event.type == SimEvent::Type::BUFF_APPLIED
+                         || event.type == SimEvent::Type::TEXT_EFFECT;
+        if(is_effect && skip_stale_effects && event.time < simulation_.getGameTime())
+            continue;
+        auto* target = entity_views_.value(event.target_id);
+        switch (event.type) {
+            case SimEvent::Type::ATTACK:{
+                auto* source = entity_views_.value(event.source_id);
+                if(source && target)
+                    source->showAttackEffect(target, event.element, *effects_);
+            } break;
+            case SimEvent::Type::BUFF_APPLIED:{
+                // Add visual effect of buff
+                if(target)
+                    target->showTextEffect(BuffUtil::buffToString(event.buff), BuffUtil::buffToColor(event.buff), *effects_);
+            } break;
+            case SimEvent::Type::TEXT_EFFECT:{
+                if(target)
+                    target->showTextEffect(ElementUtil::reactionToString(event.reaction), ElementUtil::reactionToColor(event.reaction), *effects_);
+            } break;
+            case SimEvent::Type::MONSTER_KILLED:{
+                getNewBuff(); // get new buff(s) when killing a monster
+            } break;
+            case SimEvent::Type::ENTITY_REMOVED:{
+                // Graphics may have been removed already, e.g. by removeCharacterFromUi()
+                removeEntityView(event.target_id);
+            } break;
+            default:
                 break;
-            }
         }
     }
 }
 
-void GameField::entityInteract() {
-    // Call each character::attack(), making a possible tryAttack
-    QList<Entity*> targets;
-    for(Entity* target: monsters_)
-        targets.push_back(target);
-    for(auto* character: characters_){
-        // Check if the character is ready to make an tryAttack
-        if(character->readyToAttack())
-            character->tryAttack(targets);
-    }
-    targets.clear();
-    removeDeadEntity();
-
-    // Check each monster, and try to tryAttack character in its range
-    for(Entity* target: characters_)
-        targets.push_back(target);
-    for(auto* monster: monsters_){
-        if(monster->readyToAttack())
-            monster->tryAttack(targets);
-    }
-    removeDeadEntity();
-}
-
 void GameField::updateStatusBar(){
-    health_point_counter_->setText(tr("× %1").arg(health_points_));
-    monster_counter_->setText(tr("× %1").arg(monster_que_.size()));
-}
-
-void GameField::removeDeadEntity() {
-    auto it_m = monsters_.begin();
-    while(it_m != monsters_.end()){
-        auto* monster = *it_m;
-        if(monster->isAlive()){
-            ++it_m;
-        }
-        else{
-            it_m = monsters_.erase(it_m);
-            this->removeItem(monster);
-            getNewBuff(); // get new buff(s) when killing a monster
-        }
-    }
-
-    // Cannot delete while iterating
-    // Use a list to place them temporarily
-    QList<Character*> dead_characters;
-    for(auto* character: characters_)
-        if(!character->isAlive())
-            dead_characters.push_back(character);
-    for(auto* dead_one: dead_characters)
-        removeCharacter(dead_one);
-}
-
-void GameField::removeCharacter(Character *character) {
-    auto* area = dynamic_cast<Area*>(character->parentItem());
-    if(!area)
-        throw std::runtime_error("upgrade_options_ has invalid parent");
-
-    // Update info of the area and remove the character
-    area->setOccupied(false);
-    if(!characters_.removeOne(character))
-        throw std::runtime_error("Fail to move character from list");
-    this->removeItem(character);
+    int dirty = simulation_.dirtyFlags();
+    if(dirty & Simulation::DIRTY_HEALTH_POINTS)
+        health_point_counter_->setText(tr("× %1").arg(simulation_.getHealthPoints()));
+    if(dirty & Simulation::DIRTY_MONSTER_QUEUE)
+        monster_counter_->setText(tr("× %1").arg(simulation_.getMonsterQueueSize()));
 }
 
-Character* GameField::getCharacterInArea(Area* area){
+SimEntity* GameField::getCharacterInArea(const Area* area) const {
     if(!area)
         throw std::runtime_error("area cannot be null");
-    // If the area does not have Character as a child, null would be returned
-    Character* character = nullptr;
-    for(auto* child: area->childItems()){
-        character = dynamic_cast<Character *>(child);
-        if(character)
-            break;
-    }
-    return character;
+    // If the area does not have Character in it, null would be returned
+    return simulation_.getCharacterInArea(areaIndex(area));
 }
 
 
-void GameField::updateEntityStatus() {
-    for(auto* character: characters_) {
-        character->updateStatus();
+void GameField::updateField() {
+    TickProfiler::Scope frame_scope(profiler_, "updateField");
+    constexpr qint64 tick_ns = TICK_INTERVAL * 1000000LL;
+    qint64 frame_ns = frame_clock_.restart() * 1000000LL;
+    qint64 prev_accumulator = tick_accumulator_;
+    int num_ticks = 0;
+
+    if(speed_ == MAX_SPEED){
+        // Run ticks until their share of a frame is used up, and leave no time to interpolate
+        auto budget_ns = static_cast<qint64>(timer_.interval() * MAX_SPEED_TICK_SHARE * 1000000);
+        QElapsedTimer budget;
+        budget.start();
+        while(simulation_.getState() == Simulation::State::RUNNING
+              && budget.nsecsElapsed() < budget_ns){
+            simulation_.tick();
+            ++num_ticks;
+        }
+        tick_accumulator_ = 0;
     }
-    for(auto* monster: monsters_) {
-        monster->updateStatus();
+    else{
+        // Run as many ticks as game time passed
+        tick_accumulator_ += frame_ns * speed_;
+        int max_ticks = MAX_TICKS_PER_FRAME * speed_;
+        while(tick_accumulator_ >= tick_ns
+              && num_ticks < max_ticks
+              && simulation_.getState() == Simulation::State::RUNNING){
+            simulation_.tick();
+            tick_accumulator_ -= tick_ns;
+            ++num_ticks;
+        }
+        // Too late to catch up, drop the rest
+        if(num_ticks == max_ticks)
+            tick_accumulator_ = qMin(tick_accumulator_, tick_ns - 1);
     }
-}
 
-
-void GameField::updateField() {
-    game_time_ += timer_.interval();
-    generateMonsters();
-    updateEntityStatus();
-    moveMonsters();
-    entityInteract();
-    checkReachProtectionObjective();
-    updateStatusBar();
-    checkGameEnd();
+    {
+        TickProfiler::Scope scope(profiler_, "syncEntityViews");
+        syncEntityViews(static_cast<qreal>(tick_accumulator_) / tick_ns);
+    }
+    {
+        TickProfiler::Scope scope(profiler_, "advanceEffects");
+        // Effects are animated along with game, so they stop during pause, and speed up with game
+        // Game time of this frame is ticks run plus change of time not ticked yet (which is interpolated)
+        qint64 game_ns = qMax<qint64>(num_ticks * tick_ns + tick_accumulator_ - prev_accumulator, 0);
+        effects_->advanceTime(static_cast<qreal>(game_ns) / 1000000);
+    }
+    {
+        TickProfiler::Scope scope(profiler_, "handleSimEvents");
+        handleSimEvents();
+    }
+    {
+        TickProfiler::Scope scope(profiler_, "updateStatusBar");
+        updateStatusBar();
+        // All changes are displayed now
+        simulation_.clearDirtyFlags();
+    }
+    {
+        TickProfiler::Scope scope(profiler_, "checkGameEnd");
+        checkGameEnd();
+    }
 }
 
 
-void GameField::placeCharacter(const std::function<Character*()>& maker) {
-    auto* character = maker();
+void GameField::placeCharacter(EntityKind kind) {
     auto* area = dynamic_cast<Area*>(place_options_->parentItem());
     if(!area)
         throw std::runtime_error("place_options_ has invalid parent");
 
-    // Check if the character can be placed on this area
+    // Simulation checks if the character can be placed on this area
     // e.g. Character Elf cannot be placed on road
-    if((qgraphicsitem_cast<Grass*>(area) && !character->testAreaCond(Character::ON_GRASS))
-        || (qgraphicsitem_cast<Road*>(area) && !character->testAreaCond(Character::ON_ROAD))
-       )
+    SimCommand command{SimCommand::Type::PLACE_CHARACTER, areaIndex(area), kind};
+    auto* state = simulation_.execute(command);
+    if(!state)
         return;
+    createCharacterView(*state);
+}
 
+Entity* GameField::createCharacterView(const SimEntity& state) {
+    auto* area = areas_[state.area_idx.x()][state.area_idx.y()];
+    auto* character = createEntityView(state.kind);
+    character->setEntityId(state.id);
     // Set area as parent of the character
     // So we don't need to handle coordinates
     character->setParentItem(area);
     // Set position as center of area
     character->setOffset(area->boundingRect().center() - character->boundingRect().center());
-    area->setOccupied(true);
-    characters_.push_back(character);
+    entity_views_[state.id] = character;
+    return character;
 }
 
 void GameField::upgradeCharacterFromUi() {
@@ -732,15 +588,28 @@ void GameField::removeCharacterFromUi() {
     auto* area = dynamic_cast<Area*>(upgrade_options_->parentItem());
     if(!area)
         throw std::runtime_error("upgrade_options_ has invalid parent");
-    // If not has Character as a child, exception will be thrown
-    Character* character = getCharacterInArea(area);
+    // If not has Character in it, exception will be thrown
+    SimEntity* character = getCharacterInArea(area);
     if(!character)
         throw std::runtime_error("area doesn't has a Character");
-    // Update info of the area and remove the character
-    area->setOccupied(false);
-    if(!characters_.removeOne(character))
-        throw std::runtime_error("Fail to move character from list");
-    removeItem(character);
+    // Remove graphics of the character, and the character itself from simulation
+    removeEntityView(character->id);
+    simulation_.execute({SimCommand::Type::REMOVE_CHARACTER, areaIndex(area)});
+}
+
+void GameField::removeEntityView(int entity_id) {
+    auto* view = entity_views_.take(entity_id);
+    if(!view)
+        return;
+    effects_->releaseAnchor(view);
+    if(SimEntity::isMonsterKind(view->getEntityKind())){
+        view->hide();
+        view->setEntityId(0);
+        monster_view_pool_[view->getEntityKind()].push_back(view);
+    }
+    else{
+        delete view;
+    }
 }
 
 void GameField::manageCharacterBuffFromUI(Buff buff) {
@@ -749,20 +618,20 @@ void GameField::manageCharacterBuffFromUI(Buff buff) {
         return;
 
     auto* area = dynamic_cast<Area*>(upgrade_options_->parentItem());
-    // If not has Character as a child, exception will be thrown
-    Character* character = getCharacterInArea(area);
+    // If not has Character in it, exception will be thrown
+    SimEntity* character = getCharacterInArea(area);
     if(!character)
         throw std::runtime_error("area doesn't has a Character");
-    if(character->hasBuff(buff))
-        character->removeBuff(buff);
-    else
-        character->addBuff(buff, 100 * 1000); // default duration is 100s
+    SimCommand command{SimCommand::Type::TOGGLE_BUFF, areaIndex(area)};
+    command.buff = buff;
+    simulation_.execute(command);
 
     // Play voice
     auto* player = new QMediaPlayer(this); // Parent should be set for auto deletion
     auto* audioOutput = new QAudioOutput;
     player->setAudioOutput(audioOutput);
-    player->setSource(QUrl(character->getRandomVoice()));
+    auto* character_view = dynamic_cast<Character*>(entity_views_.value(character->id));
+    player->setSource(QUrl(character_view->getRandomVoice()));
     player->setLoops(QMediaPlayer::Once);
     audioOutput->setVolume(100);
     player->play();
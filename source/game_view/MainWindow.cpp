@@ -2,10 +2,15 @@
 #include <QMenuBar>
 #include <QToolBar>
 #include <QFileDialog>
+#include <QActionGroup>
+#include <QFile>
+#include <QMessageBox>
+#include <memory>
 
 MainWindow::MainWindow(QWidget *parent): QMainWindow(parent) {
     // Initialize game field
     game_field_ = new GameField();
+    game_field_->setProfiler(&profiler_);
     game_view_ = new QGraphicsView();
     game_view_->setScene(game_field_);
     game_view_->setSceneRect(game_field_->sceneRect());
@@ -20,6 +25,12 @@ MainWindow::MainWindow(QWidget *parent): QMainWindow(parent) {
 
     auto* load_level_act = new QAction(QIcon(":/icons/plus.svg"), "New Level");
     connect(load_level_act, &QAction::triggered, this, &MainWindow::loadLevelDuringGame);
+    auto* load_level_pack_act = new QAction("Open Level Pack...");
+    connect(load_level_pack_act, &QAction::triggered, this, &MainWindow::loadLevelPackDuringGame);
+    auto* save_replay_act = new QAction("Save Replay...");
+    connect(save_replay_act, &QAction::triggered, this, &MainWindow::saveReplay);
+    auto* open_replay_act = new QAction("Open Replay...");
+    connect(open_replay_act, &QAction::triggered, this, &MainWindow::openReplay);
     auto* reset_game_act = new QAction(QIcon(":/icons/refresh.svg"), "Reset");
     connect(reset_game_act, &QAction::triggered, this, &MainWindow::resetGame);
     auto* pause_game_act = new QAction(QIcon(":/icons/pause.svg"), "Pause");
@@ -29,17 +40,45 @@ MainWindow::MainWindow(QWidget *parent): QMainWindow(parent) {
     auto* set_fps_30 = new QAction( "30");
     connect(set_fps_60, &QAction::triggered, [this](){this->setFps(60);});
     connect(set_fps_30, &QAction::triggered, [this](){this->setFps(30);});
+    auto* speed_group = new QActionGroup(this);
+    const QList<QPair<QString, int>> speed_options = {
+            {"1×", GameField::NORMAL_SPEED},
+            {"2×", 2},
+            {"4×", 4},
+            {"16×", 16},
+            {"Max", GameField::MAX_SPEED},
+    };
+    for(const auto& [text, speed]: speed_options){
+        auto* set_speed = speed_group->addAction(text);
+        set_speed->setCheckable(true);
+        set_speed->setChecked(speed == speed_);
+        connect(set_speed, &QAction::triggered, [this, speed = speed](){this->setSpeed(speed);});
+    }
+    auto* record_profile_act = new QAction("Record");
+    record_profile_act->setCheckable(true);
+    connect(record_profile_act, &QAction::toggled, [this](bool checked){profiler_.setEnabled(checked);});
+    auto* save_profile_act = new QAction("Save Trace...");
+    connect(save_profile_act, &QAction::triggered, this, &MainWindow::saveProfile);
 
     // Set MenuBar
     auto* menu_bar = menuBar();
     QMenu* file_menu = menu_bar->addMenu("&File");
     file_menu->addAction(load_level_act);
+    file_menu->addAction(load_level_pack_act);
+    file_menu->addSeparator();
+    file_menu->addAction(save_replay_act);
+    file_menu->addAction(open_replay_act);
     QMenu* game_setting_menu = menu_bar->addMenu("&Game");
     game_setting_menu->addAction(reset_game_act);
     game_setting_menu->addAction(pause_game_act);
     auto* fps_menu = game_setting_menu->addMenu("FPS");
     fps_menu->addAction(set_fps_60);
     fps_menu->addAction(set_fps_30);
+    auto* speed_menu = game_setting_menu->addMenu("Speed");
+    speed_menu->addActions(speed_group->actions());
+    auto* profiler_menu = game_setting_menu->addMenu("Profiler");
+    profiler_menu->addAction(record_profile_act);
+    profiler_menu->addAction(save_profile_act);
 
     // Set ToolBar
     auto* tool_bar = new QToolBar();
@@ -57,13 +96,11 @@ bool MainWindow::openLevelDir(){
             QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
     if(dir.isEmpty())
         return false;
-    level_data_path_ = dir;
     try {
-        game_field_->loadLevelFromFile(dir);
+        newGameField(dir);
         return true;
     }catch(std::exception& e){
-        qDebug() << "Error happened during loading file\n"
-                << e.what();
+        QMessageBox::warning(this, tr("Open a level"), e.what());
         return false;
     }
 }
@@ -72,12 +109,56 @@ void MainWindow::startGame() {
     game_field_->startGame();
 }
 
-void MainWindow::resetGame() {
+void MainWindow::newGameField(const QString& level_path) {
+    // Level is loaded into the new field before the old one is replaced,
+    // so the game running is kept if it cannot be loaded
+    auto game_field = std::make_unique<GameField>();
+    game_field->setProfiler(&profiler_);
+    game_field->loadLevelFromFile(level_path);
+    game_field->setFps(fps_);
+    game_field->setSpeed(speed_);
+    game_view_->setScene(game_field.get());
     delete game_field_;
-    game_field_ = new GameField();
-    game_field_->loadLevelFromFile(level_data_path_);
-    game_view_->setScene(game_field_);
+    game_field_ = game_field.release();
+    level_data_path_ = level_path;
+}
 
+void MainWindow::resetGame() {
+    newGameField(level_data_path_);
+    startGame();
+}
+
+void MainWindow::saveReplay() {
+    auto replay = game_field_->replay();
+    replay.level_path = level_data_path_;
+    auto file_path = QFileDialog::getSaveFileName(
+            this, tr("Save replay"),
+            "./replay.aprp",
+            tr("Replay (*.aprp)"));
+    if(file_path.isEmpty())
+        return;
+    try {
+        replay.saveToFile(file_path);
+    }catch(std::exception& e){
+        QMessageBox::warning(this, tr("Save replay"), e.what());
+    }
+}
+
+void MainWindow::openReplay() {
+    auto file_path = QFileDialog::getOpenFileName(
+            this, tr("Open replay"),
+            "./",
+            tr("Replay (*.aprp)"));
+    if(file_path.isEmpty())
+        return;
+    try {
+        auto replay = Replay::loadFromFile(file_path);
+        newGameField(replay.level_path);
+        game_field_->startReplay(replay);
+    }catch(std::exception& e){
+        QMessageBox::warning(this, tr("Open replay"), e.what());
+        return;
+    }
     startGame();
 }
 
@@ -98,15 +179,49 @@ void MainWindow::pauseOrResumeGame(bool is_pause) {
 void MainWindow::loadLevelDuringGame() {
     if(!openLevelDir())
         return;
-    resetGame();
+    startGame();
+}
+
+void MainWindow::loadLevelPackDuringGame() {
+    auto file_path = QFileDialog::getOpenFileName(
+            this, tr("Open a level pack"),
+            "./",
+            tr("Level pack (*.aplv)"));
+    if(file_path.isEmpty())
+        return;
+    try {
+        // Level pack is a file, which is loaded by Simulation::loadLevelFromFile() as well
+        newGameField(file_path);
+    }catch(std::exception& e){
+        QMessageBox::warning(this, tr("Open a level pack"), e.what());
+        return;
+    }
+    startGame();
 }
 
 void MainWindow::setFps(int fps) {
-    delete game_field_;
-    game_field_ = new GameField();
-    game_field_->loadLevelFromFile(level_data_path_);
-    game_field_->setFps(fps);
-    game_view_->setScene(game_field_);
+    // Game runs at a fixed timestep, so it's safe to change fps during game
+    fps_ = fps;
+    game_field_->setFps(fps_);
+}
 
-    startGame();
+void MainWindow::setSpeed(int speed) {
+    speed_ = speed;
+    game_field_->setSpeed(speed_);
+}
+
+void MainWindow::saveProfile() {
+    auto file_path = QFileDialog::getSaveFileName(
+            this, tr("Save trace"),
+            "./trace.json",
+            tr("Chrome trace (*.json)"));
+    if(file_path.isEmpty())
+        return;
+    QFile out_file(file_path);
+    if(!out_file.open(QIODevice::WriteOnly | QIODevice::Truncate)){
+        QMessageBox::warning(this, tr("Save trace"), tr("Cannot write to %1").arg(file_path));
+        return;
+    }
+    out_file.write(profiler_.toChromeTrace());
+    out_file.close();
 }
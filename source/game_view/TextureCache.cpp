@@ -0,0 +1,43 @@
+#include "TextureCache.h"
+#include <QTransform>
+
+size_t qHash(const TextureCache::Key& key, size_t seed) {
+    return qHashMulti(seed, key.path, key.size.width(), key.size.height(), key.horizontally_flipped);
+}
+
+QHash<TextureCache::Key, QPixmap>& TextureCache::cache() {
+    static QHash<Key, QPixmap> textures;
+    return textures;
+}
+
+QPixmap TextureCache::get(const QString& path, const QSize& size, bool horizontally_flipped) {
+    Key key{path, size, horizontally_flipped};
+    auto& textures = cache();
+    if(auto it = textures.constFind(key); it != textures.constEnd())
+        return it.value();
+
+    QPixmap texture;
+    if(horizontally_flipped){
+        // Flip the one toward right, which is cached as well
+        QTransform flip_transform;
+        flip_transform.scale(-1, 1);
+        texture = get(path, size, false).transformed(flip_transform);
+    }
+    else{
+        texture = QPixmap(path).scaled(size);
+    }
+    textures.insert(key, texture);
+    return texture;
+}
+
+QPixmap TextureCache::get(const QString& path, int size, bool horizontally_flipped) {
+    return get(path, QSize(size, size), horizontally_flipped);
+}
+
+void TextureCache::clear() {
+    cache().clear();
+}
+
+int TextureCache::size() {
+    return static_cast<int>(cache().size());
+}
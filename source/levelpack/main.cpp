@@ -0,0 +1,88 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include <stdexcept>
+#include "Simulation.h"
+
+/**
+ * Converter from a level directory (*.dat files) to a compiled level file (*.aplv), refer to LevelPack
+ * The pack is loaded back after writing, to make sure it's the same level.
+ * Time of loading both is printed, so the gain on a large level can be seen.
+ */
+
+namespace {
+
+constexpr qreal AREA_SIZE = 48; // px, same as GameField
+constexpr int TICK_INTERVAL = 16; // ms, same as GameField
+
+bool sameLevel(const Simulation& a, const Simulation& b){
+    const auto& field_a = a.field();
+    const auto& field_b = b.field();
+    if(field_a.numRows() != field_b.numRows() || field_a.numCols() != field_b.numCols()
+       || field_a.startAreasIdx() != field_b.startAreasIdx() || field_a.protectAreasIdx() != field_b.protectAreasIdx())
+        return false;
+    for(int i = 0; i < field_a.numRows(); ++i){
+        for(int j = 0; j < field_a.numCols(); ++j){
+            const auto& area_a = field_a.area(QPoint(i, j));
+            const auto& area_b = field_b.area(QPoint(i, j));
+            if(area_a.type != area_b.type || area_a.to_codes != area_b.to_codes)
+                return false;
+        }
+    }
+    return a.characterOptions() == b.characterOptions()
+           && a.getMonsterQueueSize() == b.getMonsterQueueSize()
+           && a.getHealthPoints() == b.getHealthPoints();
+}
+
+}
+
+int main(int argc, char *argv[]) try{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ap_levelpack");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Convert a level directory to a compiled level file (*.aplv)");
+    parser.addHelpOption();
+    parser.addPositionalArgument("level", "Directory of level, having field.dat, characters.dat, monsters.dat and level_setting.dat.");
+    parser.addPositionalArgument("output", "Compiled level file, <level>.aplv by default.", "[output]");
+    parser.process(app);
+
+    const auto args = parser.positionalArguments();
+    if(args.size() < 1 || args.size() > 2)
+        parser.showHelp(1);
+    QString level_path = args[0];
+    if(!QFileInfo(level_path).isDir())
+        throw std::invalid_argument("Level should be a directory");
+    QString output_path = args.size() == 2 ? args[1] : QDir::cleanPath(level_path) + ".aplv";
+
+    QElapsedTimer timer;
+    timer.start();
+    Simulation text_level(AREA_SIZE, TICK_INTERVAL);
+    text_level.loadLevelFromFile(level_path);
+    qint64 text_ns = timer.nsecsElapsed();
+    text_level.saveLevelToPack(output_path);
+
+    timer.restart();
+    Simulation packed_level(AREA_SIZE, TICK_INTERVAL);
+    packed_level.loadLevelFromPack(output_path);
+    qint64 pack_ns = timer.nsecsElapsed();
+    if(!sameLevel(text_level, packed_level))
+        throw std::runtime_error("Level loaded from pack is different from the original one");
+
+    QTextStream out(stdout);
+    out << QString("%1: %2x%3 areas, %4 monsters, %5 bytes\n")
+            .arg(output_path)
+            .arg(packed_level.field().numRows()).arg(packed_level.field().numCols())
+            .arg(packed_level.getMonsterQueueSize())
+            .arg(QFileInfo(output_path).size());
+    out << QString("load: %1 ms from *.dat, %2 ms from pack\n")
+            .arg(text_ns / 1e6, 0, 'f', 3)
+            .arg(pack_ns / 1e6, 0, 'f', 3);
+    return 0;
+}
+catch (std::exception& e){
+    qFatal("Error %s", e.what());
+}
@@ -0,0 +1,271 @@
+#include "EffectsLayer.h"
+#include <QObject>
+#include <QEasingCurve>
+#include <QFontMetricsF>
+#include <stdexcept>
+
+namespace {
+    /**
+     * Remove i-th element of list by moving the last one to it
+     * Order of records doesn't matter, so all lists of a record group do the same
+     */
+    template<typename T>
+    void swapRemove(QList<T>& list, qsizetype i){
+        list[i] = list.back();
+        list.pop_back();
+    }
+}
+
+void EffectsLayer::Shoots::removeAt(qsizetype i) {
+    swapRemove(start_pos, i);
+    swapRemove(end_pos, i);
+    swapRemove(color, i);
+    swapRemove(move_duration, i);
+    swapRemove(should_explode, i);
+    swapRemove(elapsed, i);
+}
+
+void EffectsLayer::Shoots::clear() {
+    start_pos.clear();
+    end_pos.clear();
+    color.clear();
+    move_duration.clear();
+    should_explode.clear();
+    elapsed.clear();
+}
+
+void EffectsLayer::MeleePricks::removeAt(qsizetype i) {
+    swapRemove(rest_line, i);
+    swapRemove(key_line, i);
+    swapRemove(color, i);
+    swapRemove(width, i);
+    swapRemove(duration, i);
+    swapRemove(elapsed, i);
+}
+
+void EffectsLayer::MeleePricks::clear() {
+    rest_line.clear();
+    key_line.clear();
+    color.clear();
+    width.clear();
+    duration.clear();
+    elapsed.clear();
+}
+
+void EffectsLayer::Texts::removeAt(qsizetype i) {
+    swapRemove(text, i);
+    swapRemove(color, i);
+    swapRemove(anchor, i);
+    swapRemove(pos, i);
+    swapRemove(elapsed, i);
+}
+
+void EffectsLayer::Texts::clear() {
+    text.clear();
+    color.clear();
+    anchor.clear();
+    pos.clear();
+    elapsed.clear();
+}
+
+
+EffectsLayer::EffectsLayer(int max_effects, QGraphicsItem *parent):
+    QGraphicsItem(parent),
+    max_effects_(max_effects),
+    text_font_(QObject::tr("汉仪文黑-85W"), 10)
+{
+    if(max_effects_ <= 0)
+        throw std::invalid_argument("EffectsLayer: max effects must be positive");
+}
+
+int EffectsLayer::type() const {
+    return Type;
+}
+
+QRectF EffectsLayer::boundingRect() const {
+    return rect_;
+}
+
+void EffectsLayer::setRect(const QRectF& rect) {
+    prepareGeometryChange();
+    rect_ = rect;
+}
+
+bool EffectsLayer::isFull() const {
+    return size() >= max_effects_;
+}
+
+bool EffectsLayer::add(const ShootParticle& particle) {
+    if(isFull())
+        return false;
+    shoots_.start_pos.push_back(mapFromScene(particle.getStartPos()));
+    shoots_.end_pos.push_back(mapFromScene(particle.getEndPos()));
+    shoots_.color.push_back(particle.getParticleColor());
+    shoots_.move_duration.push_back(particle.moveDuration());
+    shoots_.should_explode.push_back(particle.shouldExplode());
+    shoots_.elapsed.push_back(0);
+    update();
+    return true;
+}
+
+bool EffectsLayer::add(const MeleePrickParticle& particle) {
+    if(isFull())
+        return false;
+    auto rest_line = particle.restLine();
+    auto key_line = particle.keyLine();
+    melee_pricks_.rest_line.push_back(QLineF(mapFromScene(rest_line.p1()), mapFromScene(rest_line.p2())));
+    melee_pricks_.key_line.push_back(QLineF(mapFromScene(key_line.p1()), mapFromScene(key_line.p2())));
+    melee_pricks_.color.push_back(particle.getPen().color());
+    melee_pricks_.width.push_back(particle.getPen().widthF());
+    melee_pricks_.duration.push_back(particle.duration());
+    melee_pricks_.elapsed.push_back(0);
+    update();
+    return true;
+}
+
+bool EffectsLayer::add(const SimpleTextParticle& particle, const QGraphicsItem* anchor, QPointF pos) {
+    if(isFull())
+        return false;
+    texts_.text.push_back(particle.getText());
+    texts_.color.push_back(particle.getTextColor());
+    texts_.anchor.push_back(anchor);
+    texts_.pos.push_back(mapFromScene(pos));
+    texts_.elapsed.push_back(0);
+    update();
+    return true;
+}
+
+void EffectsLayer::advanceTime(qreal time) {
+    if(size() == 0)
+        return;
+
+    for(qsizetype i = shoots_.size() - 1; i >= 0; --i){
+        shoots_.elapsed[i] += time;
+        qreal total = shoots_.move_duration[i] + (shoots_.should_explode[i] ? ShootParticle::EXPLODE_DURATION : 0);
+        if(shoots_.elapsed[i] >= total)
+            shoots_.removeAt(i);
+    }
+    for(qsizetype i = melee_pricks_.size() - 1; i >= 0; --i){
+        melee_pricks_.elapsed[i] += time;
+        if(melee_pricks_.elapsed[i] >= melee_pricks_.duration[i])
+            melee_pricks_.removeAt(i);
+    }
+    for(qsizetype i = texts_.size() - 1; i >= 0; --i){
+        texts_.elapsed[i] += time;
+        if(texts_.elapsed[i] >= SimpleTextParticle::SCALE_DURATION + SimpleTextParticle::FADE_DURATION)
+            texts_.removeAt(i);
+    }
+    // Repaint even if all effects are removed, so that the last frame of them is cleared
+    update();
+}
+
+void EffectsLayer::releaseAnchor(const QGraphicsItem* item) {
+    for(qsizetype i = 0; i < texts_.size(); ++i){
+        if(texts_.anchor[i] != item)
+            continue;
+        texts_.pos[i] = mapFromScene(item->scenePos());
+        texts_.anchor[i] = nullptr;
+    }
+}
+
+int EffectsLayer::size() const {
+    return static_cast<int>(shoots_.size() + melee_pricks_.size() + texts_.size());
+}
+
+int EffectsLayer::getMaxEffects() const {
+    return max_effects_;
+}
+
+void EffectsLayer::setMaxEffects(int max_effects) {
+    if(max_effects <= 0)
+        throw std::invalid_argument("EffectsLayer: max effects must be positive");
+    max_effects_ = max_effects;
+}
+
+void EffectsLayer::clear() {
+    shoots_.clear();
+    melee_pricks_.clear();
+    texts_.clear();
+    update();
+}
+
+void EffectsLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    static const QEasingCurve explode_curve(QEasingCurve::OutQuart);
+    static const QEasingCurve text_scale_curve(QEasingCurve::OutCubic);
+    static const QEasingCurve text_fade_curve(QEasingCurve::OutQuart);
+
+    // Shoots
+    // Phase 1: ball moves from start pos to end pos
+    // Phase 2 (if exploding): ball grows 10 times bigger, and fades at the same time
+    painter->setPen(QPen(Qt::white));
+    for(qsizetype i = 0; i < shoots_.size(); ++i){
+        qreal elapsed = shoots_.elapsed[i];
+        qreal move_duration = shoots_.move_duration[i];
+        QPointF pos;
+        qreal scale = 1, opacity = 1;
+        if(elapsed < move_duration){
+            pos = shoots_.start_pos[i] + (shoots_.end_pos[i] - shoots_.start_pos[i]) * (elapsed / move_duration);
+        }
+        else{
+            pos = shoots_.end_pos[i];
+            qreal progress = explode_curve.valueForProgress(
+                    qMin((elapsed - move_duration) / ShootParticle::EXPLODE_DURATION, 1.0));
+            scale = 1 + 9 * progress;
+            opacity = 1 - progress;
+        }
+        painter->save();
+        painter->translate(pos);
+        painter->scale(scale, scale);
+        painter->setOpacity(opacity);
+        painter->setBrush(shoots_.color[i]);
+        painter->drawEllipse(QRectF(-3, -3, 6, 6));
+        painter->restore();
+    }
+
+    // Melee pricks
+    // Line moves from rest line to key line in first half, and back in second half
+    for(qsizetype i = 0; i < melee_pricks_.size(); ++i){
+        qreal progress = melee_pricks_.elapsed[i] / melee_pricks_.duration[i];
+        qreal t = progress < 0.5 ? progress * 2 : (1 - progress) * 2;
+        const auto& rest = melee_pricks_.rest_line[i];
+        const auto& key = melee_pricks_.key_line[i];
+        QPen pen(melee_pricks_.color[i]);
+        pen.setWidthF(melee_pricks_.width[i]);
+        pen.setCapStyle(Qt::RoundCap);
+        painter->setPen(pen);
+        painter->drawLine(QLineF(
+                rest.p1() + (key.p1() - rest.p1()) * t,
+                rest.p2() + (key.p2() - rest.p2()) * t
+                ));
+    }
+
+    // Texts
+    // Phase 1: text becomes 1.5 times bigger
+    // Phase 2: text fades
+    painter->setFont(text_font_);
+    qreal ascent = QFontMetricsF(text_font_).ascent();
+    for(qsizetype i = 0; i < texts_.size(); ++i){
+        qreal elapsed = texts_.elapsed[i];
+        qreal scale, opacity;
+        if(elapsed < SimpleTextParticle::SCALE_DURATION){
+            scale = 1 + 0.5 * text_scale_curve.valueForProgress(elapsed / SimpleTextParticle::SCALE_DURATION);
+            opacity = 1;
+        }
+        else{
+            scale = 1.5;
+            opacity = 1 - text_fade_curve.valueForProgress(
+                    qMin((elapsed - SimpleTextParticle::SCALE_DURATION) / SimpleTextParticle::FADE_DURATION, 1.0));
+        }
+        auto* anchor = texts_.anchor[i];
+        painter->save();
+        painter->translate(anchor ? mapFromScene(anchor->scenePos()) : texts_.pos[i]);
+        painter->scale(scale, scale);
+        painter->setOpacity(opacity);
+        painter->setPen(texts_.color[i]);
+        painter->drawText(QPointF(0, ascent), texts_.text[i]);
+        painter->restore();
+    }
+}
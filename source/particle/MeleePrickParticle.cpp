@@ -1,30 +1,24 @@
 #include "MeleePrickParticle.h"
+#include <QtMath>
+#include <stdexcept>
 
-int MeleePrickParticle::type() const {
-    return Type;
-}
-
-void MeleePrickParticle::startAnimation() {
-    auto *prick_animation = new QPropertyAnimation(this, "line_");
-    auto dis = qSqrt(qPow(attacker_pos_.x() - target_pos_.x(), 2) + qPow(attacker_pos_.y() - target_pos_.y(), 2));
-    auto duration = static_cast<int>(dis * 1000 / speed_);
-    prick_animation->setDuration(duration);
-
-    auto start_end_line = QLineF(
+QLineF MeleePrickParticle::restLine() const {
+    return {
             attacker_pos_,
             attacker_pos_ + (target_pos_ - attacker_pos_) * 3 / 4
-            );
-    auto key_line = QLineF(
+    };
+}
+
+QLineF MeleePrickParticle::keyLine() const {
+    return {
             attacker_pos_ + (target_pos_ - attacker_pos_) * 1 / 4,
             target_pos_
-    );
-
-    prick_animation->setStartValue(start_end_line);
-    prick_animation->setKeyValueAt(0.5, key_line);
-    prick_animation->setEndValue(start_end_line);
+    };
+}
 
-    connect(prick_animation, &QPropertyAnimation::finished, this, &MeleePrickParticle::deleteLater);
-    prick_animation->start(QAbstractAnimation::DeleteWhenStopped);
+qreal MeleePrickParticle::duration() const {
+    auto dis = qSqrt(qPow(attacker_pos_.x() - target_pos_.x(), 2) + qPow(attacker_pos_.y() - target_pos_.y(), 2));
+    return dis * 1000 / speed_;
 }
 
 void MeleePrickParticle::setAttackerPos(QPointF attacker_pos) {
@@ -40,3 +34,11 @@ void MeleePrickParticle::setSpeed(qreal speed) {
         throw std::invalid_argument("speed cannot be negative");
     speed_ = speed;
 }
+
+void MeleePrickParticle::setPen(const QPen& pen) {
+    pen_ = pen;
+}
+
+QPen MeleePrickParticle::getPen() const {
+    return pen_;
+}
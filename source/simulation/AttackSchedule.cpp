@@ -0,0 +1,173 @@
+#include "AttackSchedule.h"
+#include <algorithm>
+
+void AttackSchedule::place(qsizetype idx, const Entry& entry) {
+    heap_[idx] = entry;
+    entry.entity->schedule_idx = static_cast<int>(idx);
+}
+
+void AttackSchedule::siftUp(qsizetype idx) {
+    Entry entry = heap_[idx];
+    while(idx > 0){
+        qsizetype parent = (idx - 1) / 2;
+        if(!(entry < heap_[parent]))
+            break;
+        place(idx, heap_[parent]);
+        idx = parent;
+    }
+    place(idx, entry);
+}
+
+void AttackSchedule::siftDown(qsizetype idx) {
+    Entry entry = heap_[idx];
+    qsizetype size = heap_.size();
+    while(true){
+        qsizetype child = idx * 2 + 1;
+        if(child >= size)
+            break;
+        if(child + 1 < size && heap_[child + 1] < heap_[child])
+            ++child;
+        if(!(heap_[child] < entry))
+            break;
+        place(idx, heap_[child]);
+        idx = child;
+    }
+    place(idx, entry);
+}
+
+void AttackSchedule::removeFromHeap(SimEntity* entity) {
+    qsizetype idx = entity->schedule_idx;
+    entity->schedule_idx = -1;
+    Entry last = heap_.takeLast();
+    if(idx == heap_.size())
+        return;
+    // Fill the hole with the last one, which may go either up or down
+    place(idx, last);
+    siftUp(idx);
+    siftDown(last.entity->schedule_idx);
+}
+
+AttackSchedule::ListEntry* AttackSchedule::findInList(QList<ListEntry>& list, qsizetype begin, const SimEntity* entity) {
+    auto it = std::lower_bound(list.begin() + begin, list.end(), entity->id, [](const ListEntry& entry, int id){
+        return entry.id < id;
+    });
+    // There may be removed entries of the same entity before it
+    for(; it != list.end() && it->id == entity->id; ++it){
+        if(it->entity == entity)
+            return &*it;
+    }
+    return nullptr;
+}
+
+void AttackSchedule::advanceTo(qint64 tick) {
+    if(due_pos_ >= due_.size()){
+        due_.clear();
+        due_.swap(next_);
+    }
+    else{
+        // Some entities due in last tick are not taken, and they are still due
+        QList<ListEntry> merged;
+        merged.reserve(due_.size() - due_pos_ + next_.size());
+        std::merge(due_.begin() + due_pos_, due_.end(), next_.begin(), next_.end(), std::back_inserter(merged),
+                   [](const ListEntry& a, const ListEntry& b){ return a.id < b.id; });
+        due_.swap(merged);
+        next_.clear();
+    }
+    due_pos_ = 0;
+    last_tick_ = tick;
+}
+
+qint64 AttackSchedule::nextTick() const {
+    return last_tick_ + 1;
+}
+
+void AttackSchedule::schedule(SimEntity* entity, qint64 tick) {
+    if(tick <= nextTick()){
+        if(entity->schedule_idx == IN_LIST && findInList(next_, 0, entity))
+            return;
+        remove(entity);
+        entity->schedule_idx = IN_LIST;
+        // Entities are mostly scheduled by ascending order of id, i.e. when they're taken in a tick
+        if(next_.empty() || next_.last().id < entity->id){
+            next_.push_back({entity->id, entity});
+            return;
+        }
+        auto it = std::lower_bound(next_.begin(), next_.end(), entity->id, [](const ListEntry& entry, int id){
+            return entry.id < id;
+        });
+        next_.insert(it, {entity->id, entity});
+        return;
+    }
+    if(entity->schedule_idx < 0){
+        remove(entity);
+        heap_.push_back({tick, entity});
+        siftUp(heap_.size() - 1);
+        return;
+    }
+    qsizetype idx = entity->schedule_idx;
+    qint64 old_tick = heap_[idx].tick;
+    heap_[idx].tick = tick;
+    if(tick < old_tick)
+        siftUp(idx);
+    else
+        siftDown(idx);
+}
+
+void AttackSchedule::remove(SimEntity* entity) {
+    if(entity->schedule_idx >= 0){
+        removeFromHeap(entity);
+        return;
+    }
+    if(entity->schedule_idx != IN_LIST)
+        return;
+    entity->schedule_idx = -1;
+    if(auto* entry = findInList(next_, 0, entity))
+        entry->entity = nullptr;
+    else if(auto* due_entry = findInList(due_, due_pos_, entity))
+        due_entry->entity = nullptr;
+}
+
+SimEntity* AttackSchedule::takeDue(qint64 tick) {
+    if(tick > last_tick_)
+        advanceTo(tick);
+    while(due_pos_ < due_.size() && !due_[due_pos_].entity)
+        ++due_pos_;
+    bool heap_due = !heap_.empty() && heap_.first().tick <= tick;
+    bool list_due = due_pos_ < due_.size();
+    // The one with smaller id goes first, unless the one in heap has been due since an earlier tick
+    if(heap_due && (!list_due || heap_.first().tick < tick || heap_.first().entity->id < due_[due_pos_].id)){
+        auto* entity = heap_.first().entity;
+        removeFromHeap(entity);
+        return entity;
+    }
+    if(list_due){
+        auto* entity = due_[due_pos_++].entity;
+        entity->schedule_idx = -1;
+        return entity;
+    }
+    return nullptr;
+}
+
+void AttackSchedule::clear() {
+    for(const auto& entry: heap_)
+        entry.entity->schedule_idx = -1;
+    for(const auto& list: {&due_, &next_}){
+        for(const auto& entry: *list){
+            if(entry.entity)
+                entry.entity->schedule_idx = -1;
+        }
+    }
+    heap_.clear();
+    due_.clear();
+    next_.clear();
+    due_pos_ = 0;
+}
+
+qsizetype AttackSchedule::size() const {
+    qsizetype size = heap_.size();
+    for(qsizetype i = due_pos_; i < due_.size(); ++i)
+        size += due_[i].entity != nullptr;
+    for(const auto& entry: next_)
+        size += entry.entity != nullptr;
+    return size;
+}
@@ -0,0 +1,12 @@
+#include "ParallelUtil.h"
+#include <QThread>
+
+std::atomic<int> ParallelUtil::max_threads_ = QThread::idealThreadCount();
+
+int ParallelUtil::maxThreads() {
+    return max_threads_.load(std::memory_order_relaxed);
+}
+
+void ParallelUtil::setMaxThreads(int num_threads) {
+    max_threads_.store(qMax(num_threads, 1), std::memory_order_relaxed);
+}
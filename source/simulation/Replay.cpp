@@ -0,0 +1,69 @@
+#include "Replay.h"
+#include <QDataStream>
+#include <QFile>
+#include <stdexcept>
+#include "BuffUtil.h"
+
+// Layout of file (big endian):
+// magic (u32), version (u16), seed (u32), level_path (QString), num of commands (u32),
+// then each command: type (u8), tick (u32), row_idx (i16), col_idx (i16), kind (u8), buff ordinal (i8, -1 for none)
+
+void Replay::saveToFile(const QString& file_path) const {
+    QFile out_file(file_path);
+    if(!out_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        throw std::runtime_error("Cannot open replay file to write");
+
+    QDataStream out(&out_file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << MAGIC << VERSION << seed << level_path << static_cast<quint32>(commands.size());
+    for(const auto& command: commands){
+        out << static_cast<quint8>(command.type)
+            << static_cast<quint32>(command.tick)
+            << static_cast<qint16>(command.area_idx.x())
+            << static_cast<qint16>(command.area_idx.y())
+            << static_cast<quint8>(command.kind)
+            << static_cast<qint8>(BuffUtil::buffToOrdinal(command.buff));
+    }
+    if(out.status() != QDataStream::Ok)
+        throw std::runtime_error("Fail to write replay file");
+}
+
+Replay Replay::loadFromFile(const QString& file_path) {
+    QFile in_file(file_path);
+    if(!in_file.open(QIODevice::ReadOnly))
+        throw std::runtime_error("Cannot open replay file");
+
+    QDataStream in(&in_file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if(magic != MAGIC || version != VERSION)
+        throw std::runtime_error("Not a replay file, or made by an incompatible version");
+
+    Replay replay;
+    quint32 num_commands = 0;
+    in >> replay.seed >> replay.level_path >> num_commands;
+    for(quint32 i = 0; i < num_commands && in.status() == QDataStream::Ok; ++i){
+        quint8 type, kind;
+        quint32 tick;
+        qint16 row_idx, col_idx;
+        qint8 buff_ordinal;
+        in >> type >> tick >> row_idx >> col_idx >> kind >> buff_ordinal;
+        if(type > static_cast<quint8>(SimCommand::Type::TOGGLE_BUFF)
+           || kind > static_cast<quint8>(EntityKind::BOAR))
+            throw std::runtime_error("Invalid command in replay file");
+        SimCommand command;
+        command.type = static_cast<SimCommand::Type>(type);
+        command.tick = tick;
+        command.area_idx = QPoint(row_idx, col_idx);
+        command.kind = static_cast<EntityKind>(kind);
+        command.buff = BuffUtil::ordinalToBuff(buff_ordinal);
+        if(!replay.commands.empty() && replay.commands.back().tick > command.tick)
+            throw std::runtime_error("Commands in replay file are not sorted by tick");
+        replay.commands.push_back(command);
+    }
+    if(in.status() != QDataStream::Ok)
+        throw std::runtime_error("Replay file is truncated");
+    return replay;
+}
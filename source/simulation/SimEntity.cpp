@@ -0,0 +1,136 @@
+#include "SimEntity.h"
+#include <stdexcept>
+
+SimEntity* SimEntity::create(EntityKind kind) {
+    auto* entity = new SimEntity;
+    entity->kind = kind;
+    switch (kind) {
+        case EntityKind::ELF:
+            entity->health = entity->max_health = 1;
+            entity->can_be_attacked = false;
+            entity->damage = 10;
+            entity->recharge_time = 700; // ms
+            entity->attack_range = 5;
+            entity->area_cond = ON_GRASS;
+            break;
+        case EntityKind::KNIGHT:
+            entity->health = entity->max_health = 100;
+            entity->can_be_attacked = true;
+            entity->damage = 15;
+            entity->recharge_time = 500; // ms
+            entity->attack_range = 1;
+            entity->area_cond = ON_GRASS | ON_ROAD;
+            break;
+        case EntityKind::BOAR:
+            entity->attack_range = 1; // Monster's attack range is 1 block by default
+            entity->can_be_attacked = true;
+            entity->damage = 10;
+            entity->recharge_time = 800; // ms
+            entity->speed = 25;
+            entity->health = entity->max_health = 100;
+            break;
+        default:
+            delete entity;
+            throw std::invalid_argument("Invalid entity kind");
+    }
+    return entity;
+}
+
+bool SimEntity::isCharacterKind(EntityKind kind) {
+    return kind == EntityKind::ELF || kind == EntityKind::KNIGHT;
+}
+
+bool SimEntity::isMonsterKind(EntityKind kind) {
+    return kind == EntityKind::BOAR;
+}
+
+bool SimEntity::isCharacter() const {
+    return isCharacterKind(kind);
+}
+
+bool SimEntity::isMonster() const {
+    return isMonsterKind(kind);
+}
+
+int SimEntity::getDamage() const {
+    int real_damage = damage;
+    // If buff exists...
+    if(buffs.contains(Buff::WOLF_S_GRAVESTONE))
+        real_damage += damage * 3; // Damage increase by 30%
+
+    return real_damage;
+}
+
+int SimEntity::getHealth() const {
+    // Health is 0 at least
+    // negative value will lead to various problems among code
+    return qMax(health, 0);
+}
+
+void SimEntity::setHealth(int val) {
+    if(val == health)
+        return;
+    health = val;
+    dirty |= DIRTY_HEALTH;
+}
+
+bool SimEntity::isAlive() const {
+    return getHealth() > 0;
+}
+
+bool SimEntity::readyToAttack() const {
+    return recharged >= recharge_time;
+}
+
+qreal SimEntity::getSpeed() const {
+    qreal real_speed = speed;
+    // If buff exists...
+    // Pay attention to sequence of if-clauses
+    if(buffs.contains(Buff::WINDFALL))
+        real_speed += speed / 3; // Speed increases by 30%
+    if(buffs.contains(Buff::FROZEN))
+        real_speed = 0; // If frozen, speed would be 0 even when having a speed increase
+
+    return real_speed;
+}
+
+bool SimEntity::testAreaCond(int cond) const {
+    return (cond & area_cond) != 0;
+}
+
+void SimEntity::addBuff(Buff buff, int duration, qint64 time) {
+    if(hasBuff(buff)) {
+        buffs.set(buff, buffs.expireTime(buff) + duration);
+        return;
+    }
+
+    // An entity can have 2 buffs at most (de-buff not included)
+    if(buffs.size(~BuffUtil::DE_BUFF_MASK) >= 2)
+        return;
+
+    // An entity can have at most one infusion buff at the same time
+    if(buffs.intersects(BuffUtil::INFUSION_MASK) && BuffUtil::isInfusionBuff(buff))
+        return;
+
+    buffs.set(buff, time + duration);
+    dirty |= DIRTY_BUFFS;
+}
+
+void SimEntity::removeBuff(Buff buff) {
+    if(!hasBuff(buff))
+        return;
+    buffs.remove(buff);
+    dirty |= DIRTY_BUFFS;
+}
+
+void SimEntity::setElementAura(Element aura) {
+    if(aura == element_aura)
+        return;
+    element_aura = aura;
+    dirty |= DIRTY_AURA;
+}
+
+Buff SimEntity::getElementInfusionBuff() const {
+    // An entity can have at most one infusion buff at the same time
+    return buffs.first(BuffUtil::INFUSION_MASK);
+}
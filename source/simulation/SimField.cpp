@@ -0,0 +1,113 @@
+#include "SimField.h"
+#include <stdexcept>
+#include <QtMath>
+
+void SimArea::setDirection(const Direction& from, const Direction& to) {
+    int from_code = directionToCode(from);
+    if(from_code <= 0)
+        throw std::invalid_argument("Invalid key");
+    int to_code = directionToCode(to);
+    if(to_code < 0)
+        throw std::invalid_argument("Invalid direction");
+    int shift = (from_code - 1) * 3;
+    to_codes = static_cast<quint16>((to_codes & ~(0b111 << shift)) | (to_code << shift));
+}
+
+SimArea::Direction SimArea::getToDirection(const Direction& from) const {
+    int from_code = directionToCode(from);
+    if(from_code <= 0)
+        return qMakePair(0, 0);
+    return codeToDirection((to_codes >> ((from_code - 1) * 3)) & 0b111);
+}
+
+
+SimField::SimField(qreal area_size): area_size_(area_size) {
+
+}
+
+void SimField::reset(int num_rows, int num_cols) {
+    if(num_rows <= 0 || num_cols <= 0)
+        throw std::invalid_argument("Invalid field size");
+    num_rows_ = num_rows;
+    num_cols_ = num_cols;
+    areas_ = QList<SimArea>(num_rows_ * num_cols_);
+    start_areas_idx_.clear();
+    protect_areas_idx_.clear();
+    start_bitmap_ = QBitArray(num_rows_ * num_cols_);
+    protect_bitmap_ = QBitArray(num_rows_ * num_cols_);
+}
+
+qreal SimField::getAreaSize() const {
+    return area_size_;
+}
+
+void SimField::setAreaSize(qreal size) {
+    area_size_ = size;
+}
+
+int SimField::numRows() const {
+    return num_rows_;
+}
+
+int SimField::numCols() const {
+    return num_cols_;
+}
+
+bool SimField::contains(const AreaIndex& idx) const {
+    return idx.x() >= 0 && idx.x() < num_rows_ && idx.y() >= 0 && idx.y() < num_cols_;
+}
+
+SimArea& SimField::area(const AreaIndex& idx) {
+    return areas_[flatIndex(idx)];
+}
+
+const SimArea& SimField::area(const AreaIndex& idx) const {
+    return areas_[flatIndex(idx)];
+}
+
+void SimField::addStartArea(const AreaIndex& idx) {
+    if(!contains(idx))
+        throw std::invalid_argument("Area index out of range");
+    if(start_bitmap_.testBit(flatIndex(idx)))
+        return;
+    start_areas_idx_.push_back(idx);
+    start_bitmap_.setBit(flatIndex(idx));
+}
+
+void SimField::addProtectArea(const AreaIndex& idx) {
+    if(!contains(idx))
+        throw std::invalid_argument("Area index out of range");
+    if(protect_bitmap_.testBit(flatIndex(idx)))
+        return;
+    protect_areas_idx_.push_back(idx);
+    protect_bitmap_.setBit(flatIndex(idx));
+}
+
+const QList<SimField::AreaIndex>& SimField::startAreasIdx() const {
+    return start_areas_idx_;
+}
+
+const QList<SimField::AreaIndex>& SimField::protectAreasIdx() const {
+    return protect_areas_idx_;
+}
+
+bool SimField::isStartArea(const AreaIndex& idx) const {
+    return contains(idx) && start_bitmap_.testBit(flatIndex(idx));
+}
+
+bool SimField::isProtectArea(const AreaIndex& idx) const {
+    return contains(idx) && protect_bitmap_.testBit(flatIndex(idx));
+}
+
+QPointF SimField::indexToPos(const AreaIndex& idx) const {
+    return {area_size_ * idx.y(), area_size_ * idx.x()};
+}
+
+SimField::AreaIndex SimField::posToIndex(QPointF pos) const {
+    qreal x = pos.x();
+    qreal y = pos.y();
+    auto res = QPoint();
+    res.ry() = x < 0 ? -1 : qFloor(x + REAL_COMPENSATION) / qRound(area_size_);
+    res.rx() = y < 0 ? -1 : qFloor(y + REAL_COMPENSATION) / qRound(area_size_);
+    return res;
+}
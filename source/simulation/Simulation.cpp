@@ -0,0 +1,1148 @@
+#include "Simulation.h"
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QStringList>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "LevelPack.h"
+#include "ParallelUtil.h"
+
+
+Simulation::Simulation(qreal area_size, int refresh_interval):
+    field_(area_size),
+    refresh_interval_(refresh_interval),
+    seed_(QRandomGenerator::global()->generate()),
+    random_(seed_),
+    monster_grid_(area_size),
+    character_grid_(area_size)
+{
+    // Check if some members are initialized correctly
+    if(area_size <= 0)
+        throw std::invalid_argument("Simulation: area size not initialized correctly");
+    if(refresh_interval <= 0)
+        throw std::invalid_argument("Simulation: refresh interval not initialized correctly");
+}
+
+Simulation::~Simulation() {
+    qDeleteAll(monsters_);
+    qDeleteAll(characters_);
+}
+
+
+void Simulation::loadLevelFromFile(const QString& dir_path) {
+    if(QFileInfo(dir_path).isFile()){
+        loadLevelFromPack(dir_path);
+        return;
+    }
+    // Check if the dir exists
+    if(!QDir(dir_path).exists())
+        throw std::runtime_error("Directory does not exist");
+    // Load field data
+    loadFieldFromFile(QString("%1/field.dat").arg(dir_path));
+    // Load characters from data
+    loadCharacterOptionFromFile(QString("%1/characters.dat").arg(dir_path));
+    // Load monsters
+    loadMonsterQueueFromFile(QString("%1/monsters.dat").arg(dir_path));
+    // Load level settings
+    loadLevelSettingFromFile(QString("%1/level_setting.dat").arg(dir_path));
+    dirty_ = DIRTY_ALL;
+}
+
+void Simulation::loadFieldFromFile(const QString &file_path) {
+    QFile in_file(file_path);
+    if(!in_file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    QString line;
+    // read length and width
+    line = in_file.readLine().simplified();
+    QStringList size = line.split(u' ', Qt::SkipEmptyParts);
+    if(size.size() < 2)
+        throw std::invalid_argument("Invalid field size in field.dat");
+    SimField field(field_.getAreaSize());
+    field.reset(size[0].toInt(), size[1].toInt());
+
+    // read indices of road areas
+    // begin with a line, with size of roads in it
+    // then comes size lines, each of them looks like this:
+    // "row_idx,col_idx,to_direction,to_direction,to_direction,to_direction,road_type"
+    // The 4 directions are values mapped from {-1, 0}, {0, 1}, {1, 0}, {0, -1}
+    // Each direction_ looks like "x,y", so it should be split by ',' as well
+    // road_type: 1 to start, 2 to Protection Objective, otherwise 0
+    while(!in_file.atEnd()){
+        line = in_file.readLine().simplified();
+        if(line.size() == 0 || line.startsWith("//"))
+            continue;
+        QStringList info = line.split(u' ', Qt::SkipEmptyParts);
+        if(info.size() < 11)
+            throw std::invalid_argument("Invalid area in field.dat");
+        AreaIndex pos = QPoint(info[0].toInt(), info[1].toInt());
+        if(!field.contains(pos))
+            continue;
+        SimArea& road = field.area(pos);
+        road.type = SimArea::Type::ROAD;
+        int directions[5] = {-1, 0, 1, 0, -1};
+        for(int k = 0; k < 4; ++k){
+            QPair<int, int> from = qMakePair(directions[k], directions[k + 1]);
+            QPair<int, int> to = qMakePair(info[2 + k * 2].toInt(), info[3 + k * 2].toInt());
+            road.setDirection(from, to);
+        }
+        if(info[10].toInt() == 1)
+            field.addStartArea(pos);
+        else if(info[10].toInt() == 2)
+            field.addProtectArea(pos);
+    }
+    in_file.close();
+    setField(field);
+}
+
+void Simulation::loadCharacterOptionFromFile(const QString& file_path) {
+    // There are strings indicating characters in the file
+    // Each line represents a character, which may be "Elf", "Knight", etc.
+    QFile in_file(file_path);
+    if(!in_file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+    QString line;
+    while(!in_file.atEnd()){
+        line = in_file.readLine().trimmed();
+        if(line.size() == 0 || line.startsWith("//"))
+            continue;
+        else if(line == "Elf")
+            character_options_.push_back(EntityKind::ELF);
+        else if(line == "Knight")
+            character_options_.push_back(EntityKind::KNIGHT);
+        else
+            throw std::invalid_argument("Invalid character in characters.dat");
+    }
+    in_file.close();
+}
+
+void Simulation::loadMonsterQueueFromFile(const QString& file_path) {
+    // There lines in this file
+    // Each line is made up of (Monster name, arrival time(ms))
+    // e.g. one line is "Boar 30"
+    QFile in_file(file_path);
+    if(!in_file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    QString line;
+    while(!in_file.atEnd()){
+        line = in_file.readLine().simplified();
+        if(line.size() == 0 || line.startsWith("//"))
+            continue;
+        QStringList info = line.split(u' ', Qt::SkipEmptyParts);
+        EntityKind kind;
+        if(info[0] == "Boar")
+            kind = EntityKind::BOAR;
+        else
+            throw std::invalid_argument("Invalid monster in monsters.dat");
+        QList<Buff> buffs;
+        for(int i = 2; i < info.size(); ++i)
+            buffs.push_back(BuffUtil::stringToBuff(info[i]));
+        addMonsterArrival(kind, info[1].toInt(), buffs);
+    }
+    in_file.close();
+}
+
+void Simulation::loadLevelSettingFromFile(const QString& file_path) {
+    // Line 1: Life points of player
+    QFile in_file(file_path);
+    if(!in_file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    setHealthPoints(in_file.readLine().simplified().toInt());
+
+    in_file.close();
+}
+
+// Returns section of `count` items of T at `offset` of mapped file, after checking it's in range and aligned
+template<class T>
+static const T* packSection(const uchar* data, qint64 file_size, quint64 offset, quint64 count){
+    if(offset % alignof(T) != 0 || offset > static_cast<quint64>(file_size)
+       || count > (static_cast<quint64>(file_size) - offset) / sizeof(T))
+        throw std::runtime_error("Level pack is truncated or corrupted");
+    return reinterpret_cast<const T*>(data + offset);
+}
+
+void Simulation::loadLevelFromPack(const QString& file_path) {
+    QFile in_file(file_path);
+    if(!in_file.open(QIODevice::ReadOnly))
+        throw std::runtime_error("Cannot open level pack");
+    qint64 file_size = in_file.size();
+    // Mapping is released when in_file is destroyed
+    const uchar* data = file_size > 0 ? in_file.map(0, file_size) : nullptr;
+    if(!data)
+        throw std::runtime_error("Cannot map level pack into memory");
+
+    const auto& header = *packSection<LevelPack::Header>(data, file_size, 0, 1);
+    if(header.magic != LevelPack::MAGIC || header.version != LevelPack::VERSION
+       || header.num_buffs != BuffUtil::NUM_BUFFS)
+        throw std::runtime_error("Not a level pack, or made by an incompatible version");
+    int num_rows = header.num_rows, num_cols = header.num_cols;
+    if(num_rows <= 0 || num_cols <= 0)
+        throw std::runtime_error("Invalid size of field in level pack");
+
+    // Field
+    const auto* tiles = packSection<LevelPack::Tile>(data, file_size, header.tiles_offset,
+                                                     static_cast<quint64>(num_rows) * num_cols);
+    SimField field(field_.getAreaSize());
+    field.reset(num_rows, num_cols);
+    for(int i = 0; i < num_rows; ++i){
+        for(int j = 0; j < num_cols; ++j){
+            const auto& tile = tiles[static_cast<qint64>(i) * num_cols + j];
+            quint16 to_codes = tile.to_codes;
+            // 4 codes of 3 bits, each in [0, 4]
+            bool valid_codes = (to_codes >> 12) == 0;
+            for(int k = 0; k < 4; ++k)
+                valid_codes = valid_codes && ((to_codes >> (3 * k)) & 7) <= 4;
+            if(tile.type > static_cast<quint8>(SimArea::Type::ROAD) || !valid_codes)
+                throw std::runtime_error("Invalid area in level pack");
+            auto& area = field.area(QPoint(i, j));
+            area.type = static_cast<SimArea::Type>(tile.type);
+            area.to_codes = to_codes;
+        }
+    }
+    quint32 num_start_areas = header.num_start_areas, num_protect_areas = header.num_protect_areas;
+    const auto* area_indices = packSection<LevelPack::AreaIndex>(data, file_size, header.area_indices_offset,
+                                                                 static_cast<quint64>(num_start_areas) + num_protect_areas);
+    for(quint32 i = 0; i < num_start_areas + num_protect_areas; ++i){
+        auto idx = QPoint(area_indices[i].row_idx, area_indices[i].col_idx);
+        if(!field.contains(idx))
+            throw std::runtime_error("Invalid start area or Protection Objective in level pack");
+        if(i < num_start_areas)
+            field.addStartArea(idx);
+        else
+            field.addProtectArea(idx);
+    }
+    setField(field);
+
+    // Characters
+    const auto* character_options = packSection<quint8>(data, file_size, header.character_options_offset,
+                                                        header.num_character_options);
+    for(quint32 i = 0; i < header.num_character_options; ++i){
+        auto kind = static_cast<EntityKind>(character_options[i]);
+        if(!SimEntity::isCharacterKind(kind))
+            throw std::runtime_error("Invalid character in level pack");
+        character_options_.push_back(kind);
+    }
+
+    // Monsters
+    const auto* spawns = packSection<LevelPack::Spawn>(data, file_size, header.spawns_offset, header.num_spawns);
+    for(quint32 i = 0; i < header.num_spawns; ++i){
+        const auto& spawn = spawns[i];
+        if(spawn.kind > static_cast<quint8>(EntityKind::BOAR) || (spawn.buff_mask >> BuffUtil::NUM_BUFFS) != 0)
+            throw std::runtime_error("Invalid monster in level pack");
+        addMonsterArrival(static_cast<EntityKind>(spawn.kind), spawn.arrival_time, spawn.buff_mask);
+    }
+
+    // Level settings
+    setHealthPoints(header.health_points);
+    dirty_ = DIRTY_ALL;
+}
+
+void Simulation::loadLevelFrom(const Simulation& level) {
+    if(level.tick_count_ > 0)
+        throw std::runtime_error("Cannot load level after its game started");
+    setField(level.field_);
+    character_options_ = level.character_options_;
+    monster_que_ = level.monster_que_;
+    setHealthPoints(level.health_points_);
+    dirty_ = DIRTY_ALL;
+}
+
+void Simulation::saveLevelToPack(const QString& file_path) const {
+    if(tick_count_ > 0)
+        throw std::runtime_error("Cannot save level after game started");
+
+    const auto& start_areas_idx = field_.startAreasIdx();
+    const auto& protect_areas_idx = field_.protectAreasIdx();
+    LevelPack::Header header{};
+    header.magic = LevelPack::MAGIC;
+    header.version = LevelPack::VERSION;
+    header.num_buffs = BuffUtil::NUM_BUFFS;
+    header.num_rows = field_.numRows();
+    header.num_cols = field_.numCols();
+    header.health_points = health_points_;
+    header.num_start_areas = static_cast<quint32>(start_areas_idx.size());
+    header.num_protect_areas = static_cast<quint32>(protect_areas_idx.size());
+    header.num_character_options = static_cast<quint32>(character_options_.size());
+    header.num_spawns = static_cast<quint32>(monster_que_.size());
+    qint64 size = sizeof(LevelPack::Header);
+    header.tiles_offset = size = LevelPack::alignSection(size);
+    size += sizeof(LevelPack::Tile) * field_.numRows() * field_.numCols();
+    header.area_indices_offset = size = LevelPack::alignSection(size);
+    size += sizeof(LevelPack::AreaIndex) * (start_areas_idx.size() + protect_areas_idx.size());
+    header.character_options_offset = size = LevelPack::alignSection(size);
+    size += character_options_.size();
+    header.spawns_offset = size = LevelPack::alignSection(size);
+    size += sizeof(LevelPack::Spawn) * monster_que_.size();
+
+    QByteArray data(size, '\0');
+    memcpy(data.data(), &header, sizeof(header));
+    auto* tiles = reinterpret_cast<LevelPack::Tile*>(data.data() + header.tiles_offset);
+    for(int i = 0; i < field_.numRows(); ++i){
+        for(int j = 0; j < field_.numCols(); ++j){
+            const auto& area = field_.area(QPoint(i, j));
+            auto& tile = tiles[static_cast<qint64>(i) * field_.numCols() + j];
+            tile.to_codes = area.to_codes;
+            tile.type = static_cast<quint8>(area.type);
+        }
+    }
+    auto* area_indices = reinterpret_cast<LevelPack::AreaIndex*>(data.data() + header.area_indices_offset);
+    for(const auto& idx: start_areas_idx + protect_areas_idx){
+        area_indices->row_idx = idx.x();
+        area_indices->col_idx = idx.y();
+        ++area_indices;
+    }
+    auto* character_options = reinterpret_cast<quint8*>(data.data() + header.character_options_offset);
+    for(auto kind: character_options_)
+        *character_options++ = static_cast<quint8>(kind);
+    auto* spawns = reinterpret_cast<LevelPack::Spawn*>(data.data() + header.spawns_offset);
+    for(const auto& spawn: monster_que_){
+        spawns->arrival_time = spawn.arrival_time;
+        spawns->buff_mask = spawn.buff_mask;
+        spawns->kind = static_cast<quint8>(spawn.kind);
+        ++spawns;
+    }
+
+    QFile out_file(file_path);
+    if(!out_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        throw std::runtime_error("Cannot open level pack to write");
+    if(out_file.write(data) != data.size())
+        throw std::runtime_error("Fail to write level pack");
+}
+
+void Simulation::setField(const SimField& field) {
+    if(!monsters_.empty() || !characters_.empty())
+        throw std::runtime_error("Cannot set field when there are entities on it");
+    qreal area_size = field_.getAreaSize();
+    field_ = field;
+    field_.setAreaSize(area_size);
+    monster_grid_.reset(field_.numRows(), field_.numCols());
+    character_grid_.reset(field_.numRows(), field_.numCols());
+}
+
+void Simulation::addMonsterArrival(EntityKind kind, int arrival_time, const QList<Buff>& buffs) {
+    quint32 buff_mask = 0;
+    for(auto buff: buffs)
+        buff_mask |= BuffUtil::buffToMask(buff);
+    addMonsterArrival(kind, arrival_time, buff_mask);
+}
+
+void Simulation::addMonsterArrival(EntityKind kind, int arrival_time, quint32 buff_mask) {
+    if(!monster_que_.empty() && monster_que_.last().arrival_time > arrival_time)
+        throw std::invalid_argument("Monsters should be added by ascending order of arrival time");
+    if(!SimEntity::isMonsterKind(kind))
+        throw std::invalid_argument("Entity added to monster queue is not a monster");
+    monster_que_.enqueue({kind, arrival_time, buff_mask});
+    dirty_ |= DIRTY_MONSTER_QUEUE;
+}
+
+void Simulation::setHealthPoints(int health_points) {
+    health_points_ = health_points;
+    dirty_ |= DIRTY_HEALTH_POINTS;
+}
+
+int Simulation::getMaxAoeTargets() const {
+    return max_aoe_targets_;
+}
+
+void Simulation::setMaxAoeTargets(int max_targets) {
+    if(max_targets < 0)
+        throw std::invalid_argument("Max number of AOE targets should not be negative");
+    max_aoe_targets_ = max_targets;
+}
+
+void Simulation::tick() {
+    if(state_ != State::RUNNING)
+        return;
+    TickProfiler::Scope scope(profiler_, "tick");
+    // Commands of replay are run at the same points as they were recorded, i.e. right before next tick
+    while(!replay_commands_.empty() && replay_commands_.head().tick <= tick_count_)
+        execute(replay_commands_.dequeue());
+    ++tick_count_;
+    game_time_ += refresh_interval_;
+    runPhase("generateMonsters", &Simulation::generateMonsters);
+    runPhase("updateEntityStatus", &Simulation::updateEntityStatus);
+    runPhase("moveMonsters", &Simulation::moveMonsters);
+    runPhase("entityInteract", &Simulation::entityInteract);
+    runPhase("checkReachProtectionObjective", &Simulation::checkReachProtectionObjective);
+    runPhase("checkGameEnd", &Simulation::checkGameEnd);
+}
+
+int Simulation::getRefreshInterval() const {
+    return refresh_interval_;
+}
+
+void Simulation::setRefreshInterval(int interval) {
+    if(interval <= 0)
+        return;
+    refresh_interval_ = interval;
+    // Recharge until now is kept, and new interval is used from next tick
+    for(auto* character: characters_)
+        updateRechargeRate(character);
+    for(auto* monster: monsters_)
+        updateRechargeRate(monster);
+}
+
+const SimField& Simulation::field() const {
+    return field_;
+}
+
+qint64 Simulation::getGameTime() const {
+    return game_time_;
+}
+
+qint64 Simulation::getTickCount() const {
+    return tick_count_;
+}
+
+qint64 Simulation::getHitCount() const {
+    return num_hits_;
+}
+
+quint32 Simulation::getSeed() const {
+    return seed_;
+}
+
+void Simulation::setSeed(quint32 seed) {
+    seed_ = seed;
+    random_.seed(seed_);
+}
+
+Simulation::State Simulation::getState() const {
+    return state_;
+}
+
+int Simulation::getHealthPoints() const {
+    return health_points_;
+}
+
+int Simulation::getMonsterQueueSize() const {
+    return static_cast<int>(monster_que_.size());
+}
+
+const QList<SimEntity*>& Simulation::monsters() const {
+    return monsters_;
+}
+
+const QList<SimEntity*>& Simulation::characters() const {
+    return characters_;
+}
+
+const QList<EntityKind>& Simulation::characterOptions() const {
+    return character_options_;
+}
+
+
+SimEntity* Simulation::execute(const SimCommand& command) {
+    if(record_commands_){
+        commands_.push_back(command);
+        commands_.back().tick = tick_count_;
+    }
+
+    if(command.type == SimCommand::Type::PLACE_CHARACTER)
+        return placeCharacter(command.kind, command.area_idx);
+
+    auto* character = getCharacterInArea(command.area_idx);
+    if(!character)
+        return nullptr;
+    switch (command.type) {
+        case SimCommand::Type::REMOVE_CHARACTER:
+            removeCharacter(character);
+            return nullptr;
+        case SimCommand::Type::TOGGLE_BUFF: {
+            quint32 old_mask = character->buffs.mask();
+            if(character->hasBuff(command.buff))
+                character->removeBuff(command.buff);
+            else
+                character->addBuff(command.buff, 100 * 1000, status_time_); // default duration is 100s
+            buffsChanged(character, old_mask);
+            return character;
+        }
+        default:
+            throw std::invalid_argument("Invalid command");
+    }
+}
+
+void Simulation::setRecordCommands(bool record) {
+    record_commands_ = record;
+    if(!record_commands_)
+        commands_.clear();
+}
+
+const QList<SimCommand>& Simulation::commands() const {
+    return commands_;
+}
+
+void Simulation::startReplay(const QList<SimCommand>& commands) {
+    replaying_ = true;
+    replay_commands_.clear();
+    for(const auto& command: commands)
+        replay_commands_.enqueue(command);
+}
+
+bool Simulation::isReplaying() const {
+    return replaying_;
+}
+
+SimEntity* Simulation::placeCharacter(EntityKind kind, const AreaIndex& area_idx) {
+    if(!field_.contains(area_idx))
+        throw std::invalid_argument("Area index out of range");
+    auto& area = field_.area(area_idx);
+    if(area.occupant)
+        return nullptr;
+
+    auto* character = createEntity(kind);
+    // Check if the character can be placed on this area
+    // e.g. Character Elf cannot be placed on road
+    if((area.type == SimArea::Type::GRASS && !character->testAreaCond(SimEntity::ON_GRASS))
+        || (area.type == SimArea::Type::ROAD && !character->testAreaCond(SimEntity::ON_ROAD))
+       ) {
+        delete character;
+        return nullptr;
+    }
+
+    character->area_idx = area_idx;
+    character->pos = character->prev_pos = field_.indexToPos(area_idx);
+    area.occupant = character;
+    characters_.push_back(character);
+    character_grid_.insert(character);
+    updateRechargeRate(character);
+    return character;
+}
+
+void Simulation::removeCharacter(SimEntity *character) {
+    // Update info of the area and remove the character
+    field_.area(character->area_idx).occupant = nullptr;
+    if(!characters_.removeOne(character))
+        throw std::runtime_error("Fail to move character from list");
+    character_grid_.remove(character);
+    character_attacks_.remove(character);
+    status_wheel_.remove(character);
+    addEvent({SimEvent::Type::ENTITY_REMOVED, 0, character->id});
+    delete character;
+}
+
+SimEntity* Simulation::getCharacterInArea(const AreaIndex& area_idx) const {
+    if(!field_.contains(area_idx))
+        return nullptr;
+    return field_.area(area_idx).occupant;
+}
+
+void Simulation::setRecordEvents(bool record) {
+    record_events_ = record;
+    if(!record_events_)
+        events_.clear();
+}
+
+QList<SimEvent> Simulation::takeEvents() {
+    QList<SimEvent> events;
+    events.swap(events_);
+    return events;
+}
+
+void Simulation::setProfiler(TickProfiler* profiler) {
+    profiler_ = profiler;
+}
+
+int Simulation::dirtyFlags() const {
+    return dirty_;
+}
+
+void Simulation::clearDirtyFlags() {
+    dirty_ = 0;
+    for(auto* character: characters_)
+        character->dirty = 0;
+    for(auto* monster: monsters_)
+        monster->dirty = 0;
+}
+
+
+SimEntity* Simulation::createEntity(EntityKind kind) {
+    auto* entity = SimEntity::create(kind);
+    entity->id = next_entity_id_++;
+    entity->continuous_damage_time = entity->skill_recharged_time = status_time_;
+    return entity;
+}
+
+void Simulation::addEvent(const SimEvent& event) {
+    if(!record_events_)
+        return;
+    events_.push_back(event);
+    events_.back().time = game_time_;
+}
+
+
+void Simulation::generateMonsters() {
+    while(!monster_que_.empty() && monster_que_.head().arrival_time <= game_time_){
+        auto spawn = monster_que_.dequeue();
+        dirty_ |= DIRTY_MONSTER_QUEUE;
+        auto* monster = createEntity(spawn.kind);
+        // By default, buff duration is 100 seconds
+        for(int ordinal = 0; ordinal < BuffUtil::NUM_BUFFS; ++ordinal){
+            if(spawn.buff_mask & (1u << ordinal))
+                monster->addBuff(BuffUtil::ordinalToBuff(ordinal), 100 * 1000, status_time_);
+        }
+        monsters_.push_back(monster);
+        buffsChanged(monster, 0);
+        // Select a start area randomly
+        const auto& start_areas_idx = field_.startAreasIdx();
+        auto start_idx = start_areas_idx[random_.bounded(static_cast<int>(start_areas_idx.size()))];
+        const auto& start_area = field_.area(start_idx);
+        monster->pos = monster->prev_pos = field_.indexToPos(start_idx);
+        monster_grid_.insert(monster);
+        // Init moving direction of the monster
+        int directions[5] = {-1, 0, 1, 0, -1};
+        for(int i = 0; i < 4; ++i){
+            Direction from = qMakePair(directions[i], directions[i + 1]);
+            // C++17 If statement with initializer
+            if(auto to = start_area.getToDirection(from); to != qMakePair(0, 0)) {
+                monster->direction = to;
+                break;
+            }
+        }
+    }
+}
+
+void Simulation::updateEntityStatus() {
+    status_tick_ = tick_count_;
+    status_time_ += refresh_interval_;
+    QList<SimEntity*> due;
+    status_wheel_.advance(status_time_, due);
+    // Status of an entity only depends on itself, so entities are updated in parallel
+    ParallelUtil::forEach(due.size(), [this, &due](qsizetype i){
+        updateStatus(due[i]);
+    });
+    for(auto* entity: due)
+        scheduleStatus(entity);
+}
+
+void Simulation::updateStatus(SimEntity* entity) const {
+    manageBuff(entity);
+    doContinuousExtraDamage(entity);
+}
+
+void Simulation::manageBuff(SimEntity* entity) const {
+    quint32 mask = entity->buffs.mask();
+    entity->buffs.expire(status_time_);
+    // Some buffs expired
+    if(entity->buffs.mask() != mask)
+        entity->dirty |= SimEntity::DIRTY_BUFFS;
+    // Recharge of this tick is at new rate
+    // Entity needs no rescheduling here, refer to scheduleAttack()
+    quint32 recharge_mask = BuffUtil::buffToMask(Buff::WOLF_S_GRAVESTONE) | BuffUtil::buffToMask(Buff::FROZEN);
+    if((entity->buffs.mask() ^ mask) & recharge_mask){
+        updateRecharged(entity, status_tick_ - 1);
+        entity->recharge_rate = rechargeRate(entity);
+    }
+}
+
+void Simulation::doContinuousExtraDamage(SimEntity* entity) const {
+    int damage_rate = continuousDamageRate(entity->buffs.mask());
+    // No damage is taken
+    if(damage_rate == 0 || status_time_ - entity->continuous_damage_time < 1000)
+        return;
+
+    int num_damage = static_cast<int>((status_time_ - entity->continuous_damage_time) / 1000);
+    entity->continuous_damage_time += num_damage * 1000;
+    entity->setHealth(entity->getHealth() - num_damage * damage_rate);
+}
+
+int Simulation::continuousDamageRate(quint32 buff_mask) {
+    int damage_rate = 0;
+    if(buff_mask & BuffUtil::buffToMask(Buff::CORRODED))
+        damage_rate += 10; // Corrosion does 10 damage per second
+    return damage_rate;
+}
+
+void Simulation::scheduleStatus(SimEntity* entity) {
+    qint64 due_time = entity->buffs.nextExpireTime();
+    if(continuousDamageRate(entity->buffs.mask()) > 0)
+        due_time = qMin(due_time, entity->continuous_damage_time + 1000);
+    if(due_time == std::numeric_limits<qint64>::max())
+        return;
+    // If it's due earlier, it will be rescheduled then
+    if(!TimingWheel::contains(entity) || entity->wheel_time > due_time)
+        status_wheel_.schedule(entity, due_time);
+}
+
+void Simulation::buffsChanged(SimEntity* entity, quint32 old_mask) {
+    // Damage is counted since the last update of status, as if it was caused then
+    if(continuousDamageRate(old_mask) == 0 && continuousDamageRate(entity->buffs.mask()) > 0)
+        entity->continuous_damage_time = status_time_;
+    updateRechargeRate(entity);
+    scheduleStatus(entity);
+}
+
+int Simulation::rechargeRate(const SimEntity* entity) const {
+    int recharged_val = refresh_interval_;
+    // If buff exists...
+    if(entity->hasBuff(Buff::WOLF_S_GRAVESTONE))
+        recharged_val += refresh_interval_ / 3; // Damage speed increase by 30%
+    if(entity->hasBuff(Buff::FROZEN))
+        recharged_val = 0; // Cannot attack at all
+    return recharged_val;
+}
+
+void Simulation::updateRecharged(SimEntity* entity, qint64 tick) const {
+    entity->recharged += static_cast<int>(entity->recharge_rate * (tick - entity->recharged_tick));
+    entity->recharged_tick = tick;
+}
+
+void Simulation::updateRechargeRate(SimEntity* entity) {
+    updateRecharged(entity, status_tick_);
+    entity->recharge_rate = rechargeRate(entity);
+    scheduleAttack(entity);
+}
+
+void Simulation::scheduleAttack(SimEntity* entity) {
+    auto& schedule = entity->isCharacter() ? character_attacks_ : monster_attacks_;
+    // Ticks before it have been checked (or are being checked) for entities in the schedule
+    qint64 next_tick = schedule.nextTick();
+    qint64 due_tick = std::numeric_limits<qint64>::max();
+    qint64 recharge_left = entity->recharge_time - entity->recharged; // Since entity->recharged_tick
+    if(entity->recharge_rate * (next_tick - entity->recharged_tick) >= recharge_left)
+        due_tick = next_tick;
+    else if(entity->recharge_rate > 0)
+        due_tick = entity->recharged_tick + (recharge_left + entity->recharge_rate - 1) / entity->recharge_rate;
+    if(entity->hasBuff(Buff::FROZEN)){
+        // Buff::FROZEN is removed in the tick its duration left <= 0, refer to manageBuff()
+        qint64 duration = entity->buffs.expireTime(Buff::FROZEN) - status_time_;
+        due_tick = qMin(due_tick, status_tick_ + (duration + refresh_interval_ - 1) / refresh_interval_);
+    }
+    if(due_tick == std::numeric_limits<qint64>::max())
+        schedule.remove(entity);
+    else
+        schedule.schedule(entity, due_tick);
+}
+
+bool Simulation::tryFlash(SimEntity* monster) const {
+    if(!monster->hasBuff(Buff::EVER_CHANGING))
+        return false;
+    qint64 recharged = monster->skill_recharged + (status_time_ - monster->skill_recharged_time);
+    if(recharged < SimEntity::SKILL_CD)
+        return false;
+    monster->skill_recharged = static_cast<int>(recharged % SimEntity::SKILL_CD);
+    monster->skill_recharged_time = status_time_;
+    return true;
+}
+
+
+bool Simulation::isBlocked(const SimEntity* monster) const {
+    // Monsters and characters both take up the rect of an area,
+    // and characters are placed exactly on areas,
+    // so only areas with index {row, col}, {row + 1, col}, {row, col + 1} and {row + 1, col + 1} may overlap the monster
+    qreal area_size = field_.getAreaSize();
+    int row = qFloor(monster->pos.y() / area_size);
+    int col = qFloor(monster->pos.x() / area_size);
+    for(int i = row; i <= row + 1; ++i) {
+        for(int j = col; j <= col + 1; ++j) {
+            AreaIndex idx(i, j);
+            if(!field_.contains(idx))
+                continue;
+            auto* occupant = field_.area(idx).occupant;
+            if(occupant
+               && qAbs(monster->pos.x() - occupant->pos.x()) < area_size
+               && qAbs(monster->pos.y() - occupant->pos.y()) < area_size)
+                return true;
+        }
+    }
+    return false;
+}
+
+void Simulation::moveMonsters() {
+    // Each monster only reads field (characters don't move in this phase) and writes itself,
+    // so monsters are moved in parallel
+    ParallelUtil::forEach(monsters_.size(), [this](qsizetype i){
+        moveMonster(monsters_[i]);
+    });
+    // Grid is shared, so it's updated afterwards in order of monsters_
+    for(auto* monster: monsters_)
+        monster_grid_.move(monster);
+}
+
+void Simulation::moveMonster(SimEntity* monster) const {
+    const qreal area_size = field_.getAreaSize();
+    monster->prev_pos = monster->pos;
+
+    // Check if any character blocks its way
+    // If so, stop it from moving
+    bool blocked = isBlocked(monster);
+
+    qreal total_move_dis = monster->getSpeed() * refresh_interval_ / 1000;
+    // Try to flash if blocked by a character
+    // Default flash distance is 2 blocks' length
+    if(blocked) {
+        if(tryFlash(monster))
+            total_move_dis = area_size * 2;
+        else
+            return;
+    }
+
+    while(total_move_dis > SimField::REAL_COMPENSATION){
+        // Limit move_dis in one loop
+        // so that it is not more than one area.
+        // For security, the limit is half the size of area
+        qreal move_dis = qMin(area_size / 2, total_move_dis);
+        total_move_dis -= move_dis;
+
+        auto cur_direction = monster->direction;
+        if(cur_direction == qMakePair(0, 0))
+            break;
+        auto cur_pos = monster->pos;
+        auto next_pos = cur_pos;
+        next_pos.setX(next_pos.x() + cur_direction.first * move_dis);
+        next_pos.setY(next_pos.y() + cur_direction.second * move_dis);
+
+        auto cur_area_idx = field_.posToIndex(cur_pos);
+        auto next_area_idx = field_.posToIndex(next_pos);
+
+        // After moving, monster is in the origin area.
+        if(cur_area_idx == next_area_idx){
+            monster->pos = next_pos;
+            move_dis = 0.0;
+            const auto& cur_area = field_.area(cur_area_idx);
+            // If pos is same as any area,
+            // direction may need to be changed
+            if(pointFloatEqual(monster->pos, field_.indexToPos(cur_area_idx)))
+                monster->direction = cur_area.getToDirection(monster->direction);
+            continue;
+        }
+
+        /* Go into another area
+         *
+         * In posToIndex(), each area has two edges,
+         * so there are 2 situations.
+         *
+         * If direction is {-1, 0} or {0, -1},
+         * new direction should come from next_area
+         *
+         * Else if direction is {1, 0} or {0, 1},
+         * new direction should come from cur_area
+         *
+         * For more details, refer to code below
+         *
+         * Note:
+         * Under normal conditions, next_area would not out of range,
+         * so just ignore the condition
+         */
+        const auto& cur_area = field_.area(cur_area_idx);
+        if(cur_direction == qMakePair(-1, 0)
+           || cur_direction == qMakePair(0, -1)){
+            auto cur_area_pos = field_.indexToPos(cur_area_idx);
+            move_dis -= qAbs(cur_area_pos.x() - cur_pos.x());
+            move_dis -= qAbs(cur_area_pos.y() - cur_pos.y());
+            // Edge condition: monster's pos is exactly the pos of area,
+            // direction has been set before, and cannot be reset.
+            if(!pointFloatEqual(monster->pos, cur_area_pos))
+                monster->direction = cur_area.getToDirection(monster->direction);
+            monster->pos = cur_area_pos;
+
+            // Reach protection obj
+            if(field_.isProtectArea(cur_area_idx)){
+                monster->direction = qMakePair(0, 0);
+                break;
+            }
+
+            // Attention: if new direction is same as th old one
+            // and monster's pos is exactly the one of some area,
+            // we need to continue moving.
+            qreal cont_move_dis = qMin(area_size / 2, move_dis);
+            cur_direction = monster->direction;
+            cur_pos = monster->pos;
+            next_pos = cur_pos;
+            next_pos.setX(next_pos.x() + cur_direction.first * cont_move_dis);
+            next_pos.setY(next_pos.y() + cur_direction.second * cont_move_dis);
+            move_dis -= cont_move_dis;
+            monster->pos = next_pos;
+        }
+        else{
+            const auto& next_area = field_.area(next_area_idx);
+            auto next_area_pos = field_.indexToPos(next_area_idx);
+            move_dis -= qAbs(next_area_pos.x() - cur_pos.x());
+            move_dis -= qAbs(next_area_pos.y() - cur_pos.y());
+            monster->pos = next_area_pos;
+            monster->direction = next_area.getToDirection(monster->direction);
+            // Reach protection obj
+            if(field_.isProtectArea(next_area_idx)){
+                monster->direction = qMakePair(0, 0);
+                break;
+            }
+        }
+        // if move_dis is greater than 0, it needs to be back to total distance
+        if(move_dis > SimField::REAL_COMPENSATION)
+            total_move_dis += move_dis;
+    }
+}
+
+
+void Simulation::entityInteract() {
+    // Each character due in this tick makes a possible attack
+    // Those ready but having no target are due again in next tick
+    resolveAttacks(character_attacks_, monster_grid_);
+    removeDeadEntity();
+
+    // Each monster due in this tick tries to attack character in its range
+    resolveAttacks(monster_attacks_, character_grid_);
+    removeDeadEntity();
+}
+
+void Simulation::resolveAttacks(AttackSchedule& schedule, const SpatialGrid& targets) {
+    attackers_.clear();
+    while(auto* attacker = schedule.takeDue(tick_count_))
+        attackers_.push_back(attacker);
+
+    // Stage 1: select targets in parallel, nothing but the attacker and its own record is written
+    // If it would run on calling thread only, targets are selected in stage 2 instead, so each attacker is visited once
+    bool parallel = attackers_.size() >= ParallelUtil::MIN_PARALLEL_SIZE && ParallelUtil::maxThreads() > 1;
+    if(parallel){
+        selected_targets_.resize(attackers_.size());
+        ParallelUtil::forEach(attackers_.size(), [this, &targets](qsizetype i){
+            auto* attacker = attackers_[i];
+            updateRecharged(attacker, tick_count_);
+            selected_targets_[i] = selectTarget(attacker, targets);
+        });
+    }
+
+    // Stage 2: resolve attacks in order
+    for(qsizetype i = 0; i < attackers_.size(); ++i){
+        auto* attacker = attackers_[i];
+        SimEntity* target;
+        if(parallel){
+            target = selected_targets_[i];
+            // Target may be killed by an attack resolved before
+            if(target && !target->isAlive())
+                target = selectTarget(attacker, targets);
+        }
+        else{
+            updateRecharged(attacker, tick_count_);
+            target = selectTarget(attacker, targets);
+        }
+        if(target){
+            ActionAttack action(attacker, target);
+            attack(attacker, action, targets);
+        }
+        scheduleAttack(attacker);
+    }
+}
+
+qreal Simulation::attackRadius(const SimEntity* attacker) const {
+    return attacker->attack_range * field_.getAreaSize();
+}
+
+SimEntity* Simulation::selectTarget(const SimEntity* attacker, const SpatialGrid& targets) const {
+    if(!attacker->readyToAttack())
+        return nullptr;
+
+    // Check if any entity is in attack range
+    // If so, choose the nearest one, and the one with the least id wins in a tie,
+    // i.e. the first one added into Simulation, however entities are bucketed
+    qreal min_dis = std::numeric_limits<qreal>::max();
+    SimEntity* target = nullptr;
+    targets.forEachInRange(attacker->pos, attackRadius(attacker), [&](SimEntity* entity){
+        if(!entity->isAlive() || !entity->can_be_attacked)
+            return;
+        auto dis = SpatialGrid::distanceSquared(attacker->pos, entity->pos);
+        if(dis < min_dis || (dis == min_dis && target && entity->id < target->id)){
+            min_dis = dis;
+            target = entity;
+        }
+    });
+    return target;
+}
+
+void Simulation::attack(SimEntity* attacker, ActionAttack& action, const SpatialGrid& candidate_targets) {
+    auto* target = action.getAcceptor();
+    if(target == nullptr)
+        return;
+
+    attacker->recharged %= attacker->recharge_time;
+    action.setDamage(attacker->getDamage());
+
+    // Add buff if needed
+    // Target has 30% probability of getting a de-buff
+    // Each de-buff shares this 30% equally
+    if(random_.bounded(100) < 30) {
+        // candidate buffs (with duration) that may be attached to target, on stack since it's made per attack
+        std::array<QPair<Buff, int>, 2> candidates;
+        int num_candidates = 0;
+        if (attacker->hasBuff(Buff::INFUSION_FROZEN))
+            candidates[num_candidates++] = qMakePair(Buff::FROZEN, static_cast<int>(0.5 * 1000));
+        if (attacker->hasBuff(Buff::CAUSE_CORROSION))
+            candidates[num_candidates++] = qMakePair(Buff::CORRODED, static_cast<int>(5 * 1000));
+        // add de-buff to action
+        if(num_candidates > 0) {
+            auto&[buff, duration] = candidates[random_.bounded(num_candidates)];
+            action.setBuff(buff, duration);
+        }
+    }
+
+    // Add element infusion if needed
+    if(attacker->hasBuff(Buff::INFUSION_ANEMO))
+        action.setElement(Element::ANEMO);
+    else if(attacker->hasBuff(Buff::INFUSION_CRYO))
+        action.setElement(Element::CRYO);
+    else if(attacker->hasBuff(Buff::INFUSION_HYDRO))
+        action.setElement(Element::HYDRO);
+    else if(attacker->hasBuff(Buff::INFUSION_PYRO))
+        action.setElement(Element::PYRO);
+
+    action.setTransmitCnt(ElementUtil::elementToTransmitCnt(action.getElement()));
+
+    addEvent({SimEvent::Type::ATTACK, attacker->id, target->id, action.getElement()});
+
+    attacked(target, action, candidate_targets);
+}
+
+void Simulation::attacked(SimEntity* target, ActionAttack& action, const SpatialGrid& candidate_targets) {
+    // Entities hit by this attack (including those in worklist) are marked with its serial number
+    qint64 serial = ++attack_serial_;
+    target->hit_serial = serial;
+    int num_hit = 1;
+    // Attacks by AOE, waiting to be received
+    // It's a FIFO queue (aoe_worklist_[worklist_head] is the first), so entities are hit in order of transmits from target
+    aoe_worklist_.clear();
+    qsizetype worklist_head = 0;
+
+    // Consider range attack
+    // If damage transmit counter > 0 (after decrease), attack is turned into AOE
+    // Note: counter may be reset by element reaction (e.g. Swirl) in receiveAttack()
+    auto spread = [&](ActionAttack& from){
+        from.setTransmitCnt(from.getTransmitCnt() - 1);
+        if(from.getTransmitCnt() <= 0)
+            return;
+        // Find candidate targets near acceptor, and create new attack to them
+        aoe_nearby_.clear();
+        candidate_targets.queryRange(from.getAcceptor()->pos, field_.getAreaSize(), aoe_nearby_);
+        for(auto* candidate_target: aoe_nearby_){
+            if(num_hit > max_aoe_targets_)
+                return;
+            if(candidate_target->hit_serial == serial)
+                continue;
+            candidate_target->hit_serial = serial;
+            ++num_hit;
+            // attacker is the origin one that has attacked target
+            ActionAttack aoe(from.getInitiator(), candidate_target);
+            aoe.setTransmitCnt(from.getTransmitCnt() - 1);
+            //  aoe damage is one-third of origin damage by default
+            aoe.setDamage(from.getDamage() / 3);
+            aoe.setElement(from.getElement());
+            // No buff
+            aoe_worklist_.push_back(aoe);
+        }
+    };
+
+    action.setAcceptor(target);
+    receiveAttack(action);
+    spread(action);
+    while(worklist_head < aoe_worklist_.size()){
+        // Copied out, since spread() may reallocate the worklist
+        auto aoe = aoe_worklist_[worklist_head++];
+        receiveAttack(aoe);
+        spread(aoe);
+    }
+}
+
+void Simulation::receiveAttack(ActionAttack& action) {
+    auto* target = action.getAcceptor();
+    ++num_hits_;
+    // Receive damage from attack
+    int damage = action.getDamage();
+    target->setHealth(target->getHealth() - damage);
+
+    // Element reaction
+    if(target->element_aura == Element::NONE && ElementUtil::canApplyAura(action.getElement())){
+        target->setElementAura(action.getElement());
+    }
+    else if(action.getElement() != Element::NONE /* and element_aura is not Element::NONE */){
+        bool has_react = ElementUtil::makeElementReaction(target->element_aura, action);
+        if(has_react)
+            target->setElementAura(Element::NONE);
+    }
+
+    // Attack may carry a buff
+    auto [buff, duration] = action.getBuff();
+    if(buff != Buff::NONE) {
+        quint32 old_mask = target->buffs.mask();
+        target->addBuff(buff, duration, status_time_);
+        buffsChanged(target, old_mask);
+        SimEvent event{SimEvent::Type::BUFF_APPLIED, 0, target->id};
+        event.buff = buff;
+        addEvent(event);
+    }
+
+    // Element reaction is displayed as text effect
+    if(action.getReaction() != Reaction::NONE){
+        SimEvent event{SimEvent::Type::TEXT_EFFECT, 0, target->id};
+        event.reaction = action.getReaction();
+        addEvent(event);
+    }
+}
+
+void Simulation::removeDeadEntity() {
+    auto it_m = monsters_.begin();
+    while(it_m != monsters_.end()){
+        auto* monster = *it_m;
+        if(monster->isAlive()){
+            ++it_m;
+        }
+        else{
+            it_m = monsters_.erase(it_m);
+            monster_grid_.remove(monster);
+            monster_attacks_.remove(monster);
+            status_wheel_.remove(monster);
+            addEvent({SimEvent::Type::MONSTER_KILLED, 0, monster->id});
+            addEvent({SimEvent::Type::ENTITY_REMOVED, 0, monster->id});
+            delete monster;
+        }
+    }
+
+    // Cannot delete while iterating
+    // Use a list to place them temporarily
+    QList<SimEntity*> dead_characters;
+    for(auto* character: characters_)
+        if(!character->isAlive())
+            dead_characters.push_back(character);
+    for(auto* dead_one: dead_characters)
+        removeCharacter(dead_one);
+}
+
+void Simulation::checkReachProtectionObjective() {
+    auto it = monsters_.begin();
+    while(it != monsters_.end()){
+        SimEntity* monster = *it;
+        // Still heading for protection objective
+        if(monster->direction != qMakePair(0, 0)) {
+            ++it;
+            continue;
+        }
+        auto cur_area_idx = field_.posToIndex(monster->pos);
+        if(!field_.isProtectArea(cur_area_idx)){
+            throw std::runtime_error(
+                    "Game Error: monster direction is {0, 0} "
+                    "but hasn't reach protection objective"
+                    );
+        }
+        health_points_--;
+        dirty_ |= DIRTY_HEALTH_POINTS;
+        it = monsters_.erase(it);
+        monster_grid_.remove(monster);
+        monster_attacks_.remove(monster);
+        status_wheel_.remove(monster);
+        addEvent({SimEvent::Type::ENTITY_REMOVED, 0, monster->id});
+        delete monster;
+    }
+}
+
+void Simulation::checkGameEnd() {
+    if(health_points_ > 0 && (!monsters_.empty() || !monster_que_.empty()))
+        return;
+    state_ = (monsters_.empty() && monster_que_.empty()) ? State::WON : State::LOST;
+}
+
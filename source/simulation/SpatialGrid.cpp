@@ -0,0 +1,78 @@
+#include "SpatialGrid.h"
+#include <QtMath>
+#include <algorithm>
+#include <stdexcept>
+
+SpatialGrid::SpatialGrid(qreal cell_size): cell_size_(cell_size) {
+
+}
+
+void SpatialGrid::reset(int num_rows, int num_cols) {
+    if(num_rows <= 0 || num_cols <= 0)
+        throw std::invalid_argument("Invalid grid size");
+    for(auto& cell: cells_)
+        for(auto* entity: cell)
+            entity->grid_cell = -1;
+    num_rows_ = num_rows;
+    num_cols_ = num_cols;
+    cells_ = QList<QList<SimEntity*>>(num_rows_ * num_cols_);
+}
+
+void SpatialGrid::setCellSize(qreal size) {
+    cell_size_ = size;
+}
+
+int SpatialGrid::rowOf(qreal y) const {
+    return qBound(0, qFloor(y / cell_size_), num_rows_ - 1);
+}
+
+int SpatialGrid::colOf(qreal x) const {
+    return qBound(0, qFloor(x / cell_size_), num_cols_ - 1);
+}
+
+int SpatialGrid::cellOf(const QPointF& pos) const {
+    return rowOf(pos.y()) * num_cols_ + colOf(pos.x());
+}
+
+void SpatialGrid::insert(SimEntity* entity) {
+    if(cells_.empty())
+        throw std::runtime_error("Grid is not initialized");
+    if(entity->grid_cell >= 0)
+        throw std::invalid_argument("Entity is already in a grid");
+    entity->grid_cell = cellOf(entity->pos);
+    cells_[entity->grid_cell].push_back(entity);
+}
+
+void SpatialGrid::remove(SimEntity* entity) {
+    if(entity->grid_cell < 0)
+        return;
+    auto& cell = cells_[entity->grid_cell];
+    // Order in a cell doesn't matter, so swap it with the last one
+    auto it = std::find(cell.begin(), cell.end(), entity);
+    if(it != cell.end()) {
+        *it = cell.back();
+        cell.pop_back();
+    }
+    entity->grid_cell = -1;
+}
+
+void SpatialGrid::move(SimEntity* entity) {
+    if(entity->grid_cell < 0)
+        return;
+    int new_cell = cellOf(entity->pos);
+    if(new_cell == entity->grid_cell)
+        return;
+    remove(entity);
+    entity->grid_cell = new_cell;
+    cells_[new_cell].push_back(entity);
+}
+
+void SpatialGrid::queryRange(const QPointF& center, qreal radius, QList<SimEntity*>& result) const {
+    auto first = result.size();
+    forEachInRange(center, radius, [&result](SimEntity* entity){
+        result.push_back(entity);
+    });
+    // Keep result independent of how entities are bucketed
+    std::sort(result.begin() + first, result.end(),
+              [](const SimEntity* a, const SimEntity* b){ return a->id < b->id; });
+}
@@ -0,0 +1,102 @@
+#include "TickProfiler.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <QtAlgorithms>
+#include <stdexcept>
+
+TickProfiler::Scope::Scope(TickProfiler* profiler, const char* name):
+    profiler_(profiler && profiler->isEnabled() ? profiler : nullptr),
+    name_(name)
+{
+    if(profiler_){
+        start_count_ = profiler_->count();
+        start_ = profiler_->now();
+    }
+}
+
+TickProfiler::Scope::~Scope() {
+    if(profiler_){
+        qint64 duration = profiler_->now() - start_;
+        profiler_->record(name_, start_, duration, profiler_->count() - start_count_);
+    }
+}
+
+
+TickProfiler::TickProfiler(int capacity) {
+    if(capacity <= 0)
+        throw std::invalid_argument("Capacity of profiler should be positive");
+    ring_.resize(static_cast<qsizetype>(qNextPowerOfTwo(static_cast<quint32>(capacity - 1))));
+    mask_ = ring_.size() - 1;
+    clock_.start();
+}
+
+bool TickProfiler::isEnabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+}
+
+void TickProfiler::setEnabled(bool enabled) {
+    if(enabled && !isEnabled())
+        clear();
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+int TickProfiler::capacity() const {
+    return static_cast<int>(ring_.size());
+}
+
+qint64 TickProfiler::now() const {
+    return clock_.nsecsElapsed();
+}
+
+void TickProfiler::setCounter(Counter counter) {
+    counter_ = counter;
+}
+
+qint64 TickProfiler::count() const {
+    return counter_ ? counter_() : 0;
+}
+
+void TickProfiler::record(const char* name, qint64 start, qint64 duration, qint64 count) {
+    if(!isEnabled())
+        return;
+    // Only one thread writes, so slot is taken first and then published
+    quint64 head = head_.load(std::memory_order_relaxed);
+    ring_[static_cast<qsizetype>(head & mask_)] = {name, start, duration, count};
+    head_.store(head + 1, std::memory_order_release);
+}
+
+QList<TickProfiler::Sample> TickProfiler::samples() const {
+    quint64 head = head_.load(std::memory_order_acquire);
+    quint64 num_samples = qMin<quint64>(head, ring_.size());
+    QList<Sample> result;
+    result.reserve(static_cast<qsizetype>(num_samples));
+    for(quint64 i = head - num_samples; i < head; ++i)
+        result.push_back(ring_[static_cast<qsizetype>(i & mask_)]);
+    return result;
+}
+
+void TickProfiler::clear() {
+    head_.store(0, std::memory_order_release);
+}
+
+QByteArray TickProfiler::toChromeTrace() const {
+    QJsonArray events;
+    for(const auto& sample: samples()){
+        events.append(QJsonObject{
+                {"name", QString::fromLatin1(sample.name)},
+                {"cat", "frame"},
+                {"ph", "X"}, // Complete event, i.e. with duration
+                {"ts", static_cast<double>(sample.start) / 1000},
+                {"dur", static_cast<double>(sample.duration) / 1000},
+                {"pid", 1},
+                {"tid", 1},
+        });
+    }
+    QJsonObject trace{
+            {"traceEvents", events},
+            {"displayTimeUnit", "ms"},
+    };
+    return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
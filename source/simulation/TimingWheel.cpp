@@ -0,0 +1,108 @@
+#include "TimingWheel.h"
+#include <stdexcept>
+
+void TimingWheel::insert(SimEntity* entity) {
+    qint64 time = entity->wheel_time;
+    int level = 0;
+    // Slot of a level should be ahead of the one of now_ by less than a round
+    while(level < NUM_LEVELS - 1 && (time >> (SLOT_BITS * level)) - (now_ >> (SLOT_BITS * level)) >= NUM_SLOTS)
+        ++level;
+    int slot = slotOf(time, level);
+    if((time >> (SLOT_BITS * level)) - (now_ >> (SLOT_BITS * level)) >= NUM_SLOTS){
+        // Too far away, wait in the last slot of top level, and it's put in place when cascaded
+        slot = (slotOf(now_, level) + NUM_SLOTS - 1) & (NUM_SLOTS - 1);
+    }
+    auto& list = slots_[level * NUM_SLOTS + slot];
+    entity->wheel_slot = level * NUM_SLOTS + slot;
+    entity->wheel_pos = static_cast<int>(list.size());
+    list.push_back(entity);
+    occupied_[level] |= quint64(1) << slot;
+}
+
+void TimingWheel::cascade(int level, int slot) {
+    if(!(occupied_[level] & (quint64(1) << slot)))
+        return;
+    cascading_.swap(slots_[level * NUM_SLOTS + slot]);
+    occupied_[level] &= ~(quint64(1) << slot);
+    for(auto* entity: cascading_)
+        insert(entity);
+    cascading_.clear();
+}
+
+qint64 TimingWheel::now() const {
+    return now_;
+}
+
+void TimingWheel::schedule(SimEntity* entity, qint64 time) {
+    if(contains(entity))
+        remove(entity);
+    // Slot of now_ has been taken, so the earliest it can be due is next ms
+    entity->wheel_time = qMax(time, now_ + 1);
+    insert(entity);
+    ++size_;
+}
+
+void TimingWheel::remove(SimEntity* entity) {
+    if(!contains(entity))
+        return;
+    auto& list = slots_[entity->wheel_slot];
+    // Fill the hole with the last one
+    auto* last = list.takeLast();
+    if(last != entity){
+        list[entity->wheel_pos] = last;
+        last->wheel_pos = entity->wheel_pos;
+    }
+    if(list.empty())
+        occupied_[entity->wheel_slot / NUM_SLOTS] &= ~(quint64(1) << (entity->wheel_slot % NUM_SLOTS));
+    entity->wheel_slot = -1;
+    --size_;
+}
+
+bool TimingWheel::contains(const SimEntity* entity) {
+    return entity->wheel_slot >= 0;
+}
+
+void TimingWheel::advance(qint64 time, QList<SimEntity*>& due) {
+    while(now_ < time){
+        if(size_ == 0){
+            now_ = time;
+            return;
+        }
+        // Moved on before cascading, so that entities cascaded are placed by their distance from the time reached,
+        // e.g. one due at the last ms of a slot of level 1 goes to level 0 rather than back to the slot it's cascaded from
+        now_ += 1;
+        for(int level = NUM_LEVELS - 1; level > 0; --level){
+            if((now_ & ((qint64(1) << (SLOT_BITS * level)) - 1)) == 0)
+                cascade(level, slotOf(now_, level));
+        }
+        int slot = slotOf(now_, 0);
+        if(!(occupied_[0] & (quint64(1) << slot)))
+            continue;
+        auto& list = slots_[slot];
+        for(auto* entity: list){
+            // Each entity must be due exactly when it's taken, or buffs would outlive their duration
+            if(entity->wheel_time != now_)
+                throw std::runtime_error("Entity is taken from timing wheel at a wrong time");
+            entity->wheel_slot = -1;
+        }
+        due.append(list);
+        size_ -= list.size();
+        list.clear();
+        occupied_[0] &= ~(quint64(1) << slot);
+    }
+}
+
+void TimingWheel::clear() {
+    for(auto& list: slots_){
+        for(auto* entity: list)
+            entity->wheel_slot = -1;
+        list.clear();
+    }
+    for(auto& bits: occupied_)
+        bits = 0;
+    size_ = 0;
+}
+
+qsizetype TimingWheel::size() const {
+    return size_;
+}